@@ -0,0 +1,83 @@
+// Benchmark: operaciones de a una vs. por lotes (multi_get / multi_insert / multi_remove).
+// Uso: bench_batch [claves] [tamaño_lote]   (por defecto 2000000 claves, lotes de 64)
+// Con más de un millón de claves la tabla no entra en caché: cada búsqueda de a una
+// espera sus fallos de caché en serie; por lotes, los prefetch los solapan.
+// Las búsquedas se hacen sobre un orden aleatorio (mitad claves existentes, mitad inexistentes).
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "../linearhash.h"
+
+const int REPETICIONES = 3;
+
+std::vector<std::string> generar_claves(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> claves;
+    claves.reserve(n);
+    for (size_t k = 0; k < n; ++k) claves.push_back(std::to_string(rng()) + "_" + std::to_string(rng()));
+    return claves;
+}
+
+template<typename F>
+double medir_mops(size_t ops, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    double seg = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return double(ops) / seg / 1e6;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    size_t lote = argc > 2 ? std::stoul(argv[2]) : 64;
+    auto claves = generar_claves(n, 42);
+    auto ausentes = generar_claves(n, 7);
+    // Consultas: mitad hits, mitad misses, en orden aleatorio
+    std::vector<std::string> consultas;
+    consultas.reserve(2 * n);
+    for (size_t k = 0; k < n; ++k) {consultas.push_back(claves[k]); consultas.push_back(ausentes[k]);}
+    std::shuffle(consultas.begin(), consultas.end(), std::mt19937_64(1));
+    std::vector<std::pair<std::string, int>> items;
+    items.reserve(n);
+    for (const auto& clave : claves) items.push_back({clave, 1});
+
+    double get1 = 0, getN = 0, ins1 = 0, insN = 0, rem1 = 0, remN = 0;
+    size_t control = 0;
+    for (int r = 0; r < REPETICIONES; ++r) {
+        {
+            LinearHash<std::string, int> tabla(4);
+            ins1 = std::max(ins1, medir_mops(n, [&] {for (const auto& item : items) tabla.insert(item.first, item.second);}));
+            int valor;
+            get1 = std::max(get1, medir_mops(consultas.size(), [&] {
+                for (const auto& clave : consultas) control += tabla.try_get(clave, valor);
+            }));
+            rem1 = std::max(rem1, medir_mops(n, [&] {for (const auto& clave : claves) tabla.remove(clave);}));
+        }
+        {
+            LinearHash<std::string, int> tabla(4);
+            std::span<const std::pair<std::string, int>> todos(items);
+            insN = std::max(insN, medir_mops(n, [&] {
+                for (size_t base = 0; base < n; base += lote) tabla.multi_insert(todos.subspan(base, std::min(lote, n - base)));
+            }));
+            std::vector<int*> out(lote);
+            std::span<const std::string> qs(consultas);
+            getN = std::max(getN, medir_mops(consultas.size(), [&] {
+                for (size_t base = 0; base < qs.size(); base += lote)
+                    control += tabla.multi_get(qs.subspan(base, std::min(lote, qs.size() - base)), out);
+            }));
+            std::span<const std::string> cs(claves);
+            remN = std::max(remN, medir_mops(n, [&] {
+                for (size_t base = 0; base < n; base += lote) tabla.multi_remove(cs.subspan(base, std::min(lote, n - base)));
+            }));
+        }
+    }
+    if (control != 2 * n * REPETICIONES) cerr << "ERROR: cantidad de hits inesperada\n";
+    cout << n << " claves, lotes de " << lote << " (Mops/s, mejor de " << REPETICIONES << ")\n";
+    cout << setw(10) << "op" << setw(12) << "de a una" << setw(12) << "por lotes" << "\n" << fixed << setprecision(2);
+    cout << setw(10) << "get" << setw(12) << get1 << setw(12) << getN << "\n";
+    cout << setw(10) << "insert" << setw(12) << ins1 << setw(12) << insN << "\n";
+    cout << setw(10) << "remove" << setw(12) << rem1 << setw(12) << remN << "\n";
+    return 0;
+}
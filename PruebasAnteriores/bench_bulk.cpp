@@ -0,0 +1,51 @@
+// Benchmark: carga masiva de claves en LinearHash.
+// Uso: bench_bulk [claves] [hilos]   (por defecto 10000000 claves, todos los núcleos)
+// Compara:
+//  - insert de a uno (un split cada pocas inserciones)
+//  - reserve(n) + insert de a uno (sin splits)
+//  - bulk_build en paralelo
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../linearhash.h"
+
+template<typename F>
+double medir_ms(F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    unsigned hilos = argc > 2 ? unsigned(std::stoul(argv[2])) : std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937_64 rng(42);
+    std::vector<std::pair<std::string, int>> items;
+    items.reserve(n);
+    for (size_t k = 0; k < n; ++k) items.push_back({std::to_string(rng()) + "_" + std::to_string(rng()), int(k)});
+
+    cout << n << " claves, " << hilos << " hilos (ms)\n" << fixed << setprecision(1);
+    {
+        LinearHash<std::string, int> tabla(4);
+        double t = medir_ms([&] {for (const auto& item : items) tabla.insert(item.first, item.second);});
+        cout << setw(22) << left << "insert" << right << setw(10) << t << "\n";
+    }
+    {
+        LinearHash<std::string, int> tabla(4);
+        double t = medir_ms([&] {
+            tabla.reserve(n);
+            for (const auto& item : items) tabla.insert(item.first, item.second);
+        });
+        cout << setw(22) << left << "reserve + insert" << right << setw(10) << t << "\n";
+    }
+    {
+        LinearHash<std::string, int> tabla(4);
+        double t = medir_ms([&] {tabla.bulk_build(items, hilos);});
+        cout << setw(22) << left << "bulk_build" << right << setw(10) << t << "\n";
+        if (tabla.size() != int(n)) cerr << "ERROR: bulk_build dejó " << tabla.size() << " claves\n";
+    }
+    return 0;
+}
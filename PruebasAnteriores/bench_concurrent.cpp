@@ -0,0 +1,105 @@
+// Benchmark multihilo: LinearHash protegido con un mutex global vs. ShardedLinearHash
+// (N shards, lecturas sin lock mientras nadie escribe el shard) vs. ConcurrentLinearHash.
+// Uso: bench_concurrent [claves] [ops_por_hilo]
+// Se precargan "claves" tokens y cada hilo ejecuta una mezcla parecida al servidor:
+// 90% try_get (/servicio), 5% insert (/login), 5% remove (/logout).
+// Después se repite con 100% try_get: ConcurrentLinearHash y ShardedLinearHash leen sin locks
+// y deberían escalar con los hilos. Es la comparación que importa para /servicio: main.cpp usa
+// ShardedLinearHash en lugar de los lectores por épocas, y la columna "shards/conc" tiene que
+// quedar cerca de 1 con todos los hilos.
+// Se reporta el throughput total (millones de operaciones por segundo, mejor de REPETICIONES)
+// para 1..2N hilos.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../linearhash.h"
+#include "../concurrentlinearhash.h"
+#include "../shardedlinearhash.h"
+
+const int REPETICIONES = 3;
+
+// Adaptador: la tabla secuencial con un único mutex (lo que haría main.cpp sin striping)
+template<typename TK, typename TV>
+struct GlobalMutexTable {
+    LinearHash<TK, TV> tabla;
+    std::mutex mutex;
+    GlobalMutexTable(int M0): tabla(M0) {}
+    bool try_get(const TK& key, TV& out) {std::lock_guard<std::mutex> lock(mutex); return tabla.try_get(key, out);}
+    void insert(const TK& key, const TV& value) {std::lock_guard<std::mutex> lock(mutex); tabla.insert(key, value);}
+    bool remove(const TK& key) {std::lock_guard<std::mutex> lock(mutex); return tabla.remove(key);}
+};
+
+std::vector<std::string> generar_claves(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> claves;
+    claves.reserve(n);
+    for (size_t k = 0; k < n; ++k) claves.push_back(std::to_string(rng()) + "_" + std::to_string(rng()));
+    return claves;
+}
+
+// 4 shards por núcleo, como en main.cpp
+template<typename TK, typename TV>
+struct ShardedTable : ShardedLinearHash<TK, TV> {
+    ShardedTable(int M0): ShardedLinearHash<TK, TV>(std::max(4u, 4 * std::thread::hardware_concurrency()), M0) {}
+};
+
+template<typename Tabla>
+double correr_una(const std::vector<std::string>& claves, int hilos, size_t ops, unsigned lecturas) {
+    Tabla tabla(4);
+    for (const auto& clave : claves) tabla.insert(clave, 1);
+    std::atomic<bool> largada(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < hilos; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 rng(t + 1);
+            int valor;
+            while (!largada.load()) std::this_thread::yield();
+            for (size_t op = 0; op < ops; ++op) {
+                const std::string& clave = claves[rng() % claves.size()];
+                unsigned dado = rng() % 100;
+                if (dado < lecturas) tabla.try_get(clave, valor);
+                else if (dado < lecturas + (100 - lecturas) / 2) tabla.insert(clave, 2);
+                else tabla.remove(clave);
+            }
+        });
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    largada.store(true);
+    for (auto& w : workers) w.join();
+    double seg = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return double(ops) * hilos / seg / 1e6;
+}
+
+template<typename Tabla>
+double correr(const std::vector<std::string>& claves, int hilos, size_t ops, unsigned lecturas) {
+    double mejor = 0;
+    for (int r = 0; r < REPETICIONES; ++r) mejor = std::max(mejor, correr_una<Tabla>(claves, hilos, ops, lecturas));
+    return mejor;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t ops = argc > 2 ? std::stoul(argv[2]) : 500000;
+    int max_hilos = std::max(1u, std::thread::hardware_concurrency());
+    auto claves = generar_claves(n, 42);
+    for (unsigned lecturas : {90u, 100u}) {
+        cout << n << " claves, " << ops << " ops por hilo (" << lecturas << "% get / "
+             << (100 - lecturas) / 2 << "% insert / " << (100 - lecturas) / 2 << "% remove), Mops/s\n";
+        cout << setw(6) << "hilos" << setw(16) << "mutex global" << setw(16) << "shards" << setw(16) << "concurrente"
+             << setw(14) << "shards/conc" << "\n";
+        for (int hilos = 1; hilos <= max_hilos * 2; hilos *= 2) {
+            double global = correr<GlobalMutexTable<std::string, int>>(claves, hilos, ops, lecturas);
+            double sharded = correr<ShardedTable<std::string, int>>(claves, hilos, ops, lecturas);
+            double concurrente = correr<ConcurrentLinearHash<std::string, int>>(claves, hilos, ops, lecturas);
+            cout << setw(6) << hilos << fixed << setprecision(2) << setw(16) << global << setw(16) << sharded
+                 << setw(16) << concurrente << setw(14) << sharded / concurrente << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Benchmark: LinearHashFile (tabla en disco) con distintos tamaños de buffer pool.
+// Uso: bench_file [claves] [archivo]   (por defecto 200000 claves, bench_file.db)
+// Carga claves con forma de sesión (token -> correo), después hace búsquedas al azar
+// (mitad existentes, mitad inexistentes) y borra la mitad. Para cada tamaño de pool
+// muestra Kops/s y las lecturas/escrituras de páginas por operación: con el pool chico
+// casi cada búsqueda va al disco; con el pool del tamaño del archivo no lee nada.
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "../linearhashfile.h"
+
+std::vector<std::string> generar_claves(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> claves;
+    claves.reserve(n);
+    for (size_t k = 0; k < n; ++k) claves.push_back(std::to_string(rng()) + "_" + std::to_string(rng()));
+    return claves;
+}
+
+template<typename F>
+double medir_kops(size_t ops, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    double seg = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return double(ops) / seg / 1e3;
+}
+
+double por_op(const LinearHashFileIOStats& io, LinearHashFileOp op) {
+    int o = int(op);
+    return io.ops[o] ? double(io.reads[o] + io.writes[o]) / double(io.ops[o]) : 0.0;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 200000;
+    std::string archivo = argc > 2 ? argv[2] : "bench_file.db";
+    auto claves = generar_claves(n, 42);
+    auto ausentes = generar_claves(n, 7);
+    std::vector<std::string> consultas;
+    consultas.reserve(2 * n);
+    for (size_t k = 0; k < n; ++k) {consultas.push_back(claves[k]); consultas.push_back(ausentes[k]);}
+    std::shuffle(consultas.begin(), consultas.end(), std::mt19937_64(1));
+
+    cout << n << " claves, paginas de 4096 bytes (Kops/s y E/S de paginas por op)\n";
+    cout << setw(8) << "pool" << setw(10) << "insert" << setw(8) << "E/S" << setw(10) << "get" << setw(8) << "E/S"
+         << setw(10) << "remove" << setw(8) << "E/S" << setw(10) << "paginas" << "\n" << fixed << setprecision(2);
+    for (size_t pool : {64, 1024, 16384}) {
+        std::filesystem::remove(archivo);
+        size_t control = 0;
+        LinearHashFile<std::string, std::string> tabla(archivo, pool);
+        double ins = medir_kops(n, [&] {for (const auto& clave : claves) tabla.insert(clave, "usuario" + clave.substr(0, 6) + "@correo.com");});
+        std::string valor;
+        double get = medir_kops(consultas.size(), [&] {for (const auto& clave : consultas) control += tabla.try_get(clave, valor);});
+        double rem = medir_kops(n / 2, [&] {for (size_t k = 0; k < n / 2; ++k) tabla.remove(claves[k]);});
+        if (control != n) cerr << "ERROR: cantidad de hits inesperada\n";
+        const LinearHashFileIOStats& io = tabla.io_stats();
+        cout << setw(8) << pool << setw(10) << ins << setw(8) << por_op(io, LinearHashFileOp::insert)
+             << setw(10) << get << setw(8) << por_op(io, LinearHashFileOp::get)
+             << setw(10) << rem << setw(8) << por_op(io, LinearHashFileOp::remove)
+             << setw(10) << tabla.page_count() << "\n";
+    }
+    std::filesystem::remove(archivo);
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Benchmark: PagedLinearHash (páginas con tags) vs. LinearHash (cadenas de nodos).
+// Uso: bench_paged [claves] [operaciones_de_prueba]   (por defecto 1000000 claves, 2000000 operaciones)
+// Antes de medir se verifica PagedLinearHash contra std::unordered_map con operaciones al
+// azar (insert / remove / try_get / contains / operator[] / for_each_remove_if / clear) sobre
+// un conjunto chico de claves, así cada operación cae seguido sobre claves que ya están y los
+// splits / merges / páginas de overflow se ejercitan. Si algo no coincide, termina con error.
+// Después mide insert, get de claves que están y búsquedas fallidas (el caso que optimizan los
+// tags: linearhash_match_tags / find_slot descartan la página sin comparar claves), con 100% y
+// 90% de misses. Dos targets: bench_paged (tags con SSE2, o AVX2 con -mavx2) y
+// bench_paged_scalar (-DLINEARHASH_NO_SIMD, comparación byte a byte).
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../linearhash.h"
+#include "../pagedlinearhash.h"
+
+const int REPETICIONES = 3;
+
+std::vector<std::string> generar_claves(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> claves;
+    claves.reserve(n);
+    for (size_t k = 0; k < n; ++k) claves.push_back(std::to_string(rng()) + "_" + std::to_string(rng()));
+    return claves;
+}
+
+template<typename F>
+double medir_mops(size_t ops, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    double seg = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return double(ops) / seg / 1e6;
+}
+
+// Compara tabla y referencia completas: mismo tamaño y cada clave con su valor
+template<typename Tabla>
+bool iguales(Tabla& tabla, const std::unordered_map<std::string, int>& referencia) {
+    if (size_t(tabla.size()) != referencia.size()) return false;
+    int valor;
+    for (const auto& [clave, esperado] : referencia) {
+        if (!tabla.try_get(clave, valor) || valor != esperado) return false;
+    }
+    return true;
+}
+
+// Operaciones al azar contra std::unordered_map; devuelve false (y dice dónde) si difieren
+bool verificar(size_t operaciones, uint64_t seed) {
+    // Pocas claves y páginas de 4 slots: muchas páginas de overflow, splits y merges
+    auto claves = generar_claves(2000, seed);
+    PagedLinearHash<std::string, int, 4> tabla(4);
+    std::unordered_map<std::string, int> referencia;
+    std::mt19937_64 rng(seed);
+    auto falla = [&](size_t op, const char* que) {
+        cout << "[ERROR] seed=" << seed << " op=" << op << ": " << que << "\n";
+        return false;
+    };
+    for (size_t op = 0; op < operaciones; ++op) {
+        // La cantidad de claves en juego sube y baja, para que la tabla crezca y se achique
+        size_t activas = 1 + (op / 50000 % 2 == 0 ? op % 50000 : 50000 - op % 50000) * claves.size() / 50000;
+        const std::string& clave = claves[rng() % std::min(activas, claves.size())];
+        int valor = int(rng() % 1000), leido;
+        unsigned dado = unsigned(rng() % 1000);
+        if (dado < 450) {
+            tabla.insert(clave, valor);
+            referencia[clave] = valor;
+        } else if (dado < 750) {
+            if (tabla.remove(clave) != (referencia.erase(clave) == 1)) return falla(op, "remove");
+        } else if (dado < 900) {
+            auto it = referencia.find(clave);
+            bool esta = tabla.try_get(clave, leido);
+            if (esta != (it != referencia.end()) || (esta && leido != it->second)) return falla(op, "try_get");
+        } else if (dado < 950) {
+            if (tabla.contains(clave) != referencia.contains(clave)) return falla(op, "contains");
+        } else if (dado < 990) {
+            auto it = referencia.find(clave);
+            try {
+                leido = tabla[clave];
+                if (it == referencia.end() || leido != it->second) return falla(op, "operator[]");
+            } catch (const std::runtime_error&) {
+                if (it != referencia.end()) return falla(op, "operator[] (no encontro)");
+            }
+        } else if (dado < 999) {
+            // Borra los valores múltiplos de un número al azar
+            int divisor = 2 + int(rng() % 5);
+            auto borrar = [divisor](const std::string&, int& v) {return v % divisor == 0;};
+            size_t antes = referencia.size();
+            std::erase_if(referencia, [divisor](const auto& item) {return item.second % divisor == 0;});
+            if (size_t(tabla.for_each_remove_if(borrar).removed) != antes - referencia.size())
+                return falla(op, "for_each_remove_if");
+            if (!iguales(tabla, referencia)) return falla(op, "contenido despues de for_each_remove_if");
+        } else {
+            tabla.clear();
+            referencia.clear();
+        }
+        if (size_t(tabla.size()) != referencia.size()) return falla(op, "size");
+        if (op % 100000 == 0 && !iguales(tabla, referencia)) return falla(op, "contenido");
+    }
+    return iguales(tabla, referencia) || falla(operaciones, "contenido final");
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t operaciones = argc > 2 ? std::stoul(argv[2]) : 2000000;
+    for (uint64_t seed : {1, 2, 3}) {
+        if (!verificar(operaciones, seed)) return 1;
+    }
+    cout << "verificacion contra std::unordered_map: OK (3 x " << operaciones << " operaciones, tags "
+         << LINEARHASH_TAG_ISA << ")\n";
+
+    auto claves = generar_claves(n, 42);
+    std::vector<std::string> consultas = claves;
+    std::shuffle(consultas.begin(), consultas.end(), std::mt19937_64(1));
+    // Misses: claves que nunca se insertan; la mezcla del 90% intercala una clave presente cada 10
+    auto misses = generar_claves(n, 7);
+    std::vector<std::string> mezcla = misses;
+    for (size_t k = 0; k < n; k += 10) mezcla[k] = consultas[k];
+    // Mejor de REPETICIONES para cada tabla: insert, get (hits), 100% misses, 90% misses
+    struct Fila {double insert = 0, get = 0, miss = 0, mezcla = 0;} lista, paginas;
+    size_t control = 0;
+    auto medir = [&](auto& tabla, Fila& fila) {
+        int valor;
+        fila.insert = std::max(fila.insert, medir_mops(n, [&] {for (const auto& clave : claves) tabla.insert(clave, 1);}));
+        fila.get = std::max(fila.get, medir_mops(n, [&] {
+            for (const auto& clave : consultas) control += tabla.try_get(clave, valor);
+        }));
+        fila.miss = std::max(fila.miss, medir_mops(n, [&] {
+            for (const auto& clave : misses) control += tabla.try_get(clave, valor);
+        }));
+        fila.mezcla = std::max(fila.mezcla, medir_mops(n, [&] {
+            for (const auto& clave : mezcla) control += tabla.try_get(clave, valor);
+        }));
+    };
+    double paginas_por_miss = 0;
+    for (int r = 0; r < REPETICIONES; ++r) {
+        {
+            LinearHash<std::string, int> tabla(4);
+            medir(tabla, lista);
+        }
+        {
+            PagedLinearHash<std::string, int> tabla(4);
+            medir(tabla, paginas);
+            // Páginas que mira un miss (la primaria más las de overflow de su bucket)
+            int antes = tabla.visited_buckets();
+            for (const auto& clave : misses) control += tabla.contains(clave);
+            paginas_por_miss = double(tabla.visited_buckets() - antes) / double(n);
+        }
+    }
+    cout << n << " claves, Mops/s (mejor de " << REPETICIONES << "), tags " << LINEARHASH_TAG_ISA << "\n";
+    cout << setw(10) << "" << setw(12) << "insert" << setw(12) << "get" << setw(12) << "miss" << setw(12) << "90% miss" << "\n";
+    cout << fixed << setprecision(2);
+    for (auto [nombre, fila] : {std::pair<const char*, Fila>{"lista", lista}, {"paginas", paginas}}) {
+        cout << setw(10) << nombre << setw(12) << fila.insert << setw(12) << fila.get << setw(12) << fila.miss
+             << setw(12) << fila.mezcla << "\n";
+    }
+    cout << "paginas visitadas por miss: " << paginas_por_miss << "\n";
+    cout << "(" << control % 10 << ")\n";
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Benchmark: LinearHash con new/delete por nodo vs. pool de nodos por slabs.
+// Uso: bench_pool [carpeta_con_csv]   (por defecto ../PruebasAnteriores)
+// Para cada dataset productos*.csv mide (mejor de REPETICIONES corridas):
+//  - insert de todas las claves
+//  - try_get de todas las claves
+//  - churn: remove + insert de cada clave (simula logout/login)
+//  - remove de todas las claves
+//  - clear de una tabla llena
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include "../linearhash.h"
+#include "loadcsv.h"
+
+const int REPETICIONES = 5;
+
+struct Tiempos {
+    double insert = 1e18, get = 1e18, churn = 1e18, remove = 1e18, clear = 1e18;
+};
+
+template<typename F>
+double medir_ms(F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+template<typename Tabla>
+Tiempos correr(const vector<pair<string, string>>& data) {
+    Tiempos best;
+    for (int r = 0; r < REPETICIONES; ++r) {
+        Tabla tabla(4);
+        string valor;
+        size_t encontrados = 0;
+        best.insert = min(best.insert, medir_ms([&] {
+            for (const auto& kv : data) tabla.insert(kv.first, kv.second);
+        }));
+        best.get = min(best.get, medir_ms([&] {
+            for (const auto& kv : data) encontrados += tabla.try_get(kv.first, valor);
+        }));
+        best.churn = min(best.churn, medir_ms([&] {
+            for (const auto& kv : data) {
+                tabla.remove(kv.first);
+                tabla.insert(kv.first, kv.second);
+            }
+        }));
+        best.remove = min(best.remove, medir_ms([&] {
+            for (const auto& kv : data) tabla.remove(kv.first);
+        }));
+        for (const auto& kv : data) tabla.insert(kv.first, kv.second);
+        best.clear = min(best.clear, medir_ms([&] {tabla.clear();}));
+        if (encontrados != data.size()) cerr << "ERROR: faltan claves en try_get\n";
+    }
+    return best;
+}
+
+void imprimir(const string& nombre, const Tiempos& t) {
+    cout << "  " << left << setw(12) << nombre << right << fixed << setprecision(3)
+         << setw(10) << t.insert << setw(10) << t.get << setw(10) << t.churn
+         << setw(10) << t.remove << setw(10) << t.clear << "\n";
+}
+
+int main(int argc, char** argv) {
+    string carpeta = argc > 1 ? argv[1] : "../PruebasAnteriores";
+    const char* archivos[] = {"productos1000.csv", "productos10000.csv", "productos20000.csv",
+                              "productos50000.csv", "productos100000.csv"};
+    for (const char* archivo : archivos) {
+        auto data = loadCSV(carpeta + "/" + archivo);
+        if (data.empty()) continue;
+        cout << archivo << " (" << data.size() << " claves, tiempos en ms)\n";
+        cout << "  " << left << setw(12) << "modo" << right << setw(10) << "insert" << setw(10) << "get"
+             << setw(10) << "churn" << setw(10) << "remove" << setw(10) << "clear" << "\n";
+        imprimir("new/delete", correr<LinearHash<string, string>>(data));
+        imprimir("pool", correr<LinearHash<string, string, LinearHashHasher<string>, std::equal_to<>, LinearHashPoolAllocator>>(data));
+    }
+    return 0;
+}
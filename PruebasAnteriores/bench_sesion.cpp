@@ -0,0 +1,106 @@
+// Benchmark: Sesion con correo y password propios (antes) vs. Sesion compacta (correo
+// internado + vencimiento, password en una tabla aparte).
+// Uso: bench_sesion [usuarios] [sesiones_por_usuario]   (por defecto 200000 x 5)
+// Informa bytes por sesión (estimación de las tablas: nodo + memoria dinámica, más el pool
+// de correos) y ns por get, que copia la Sesion como lo hace /servicio con try_get.
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "../linearhash.h"
+#include "../sessionid.h"
+#include "../internpool.h"
+
+const int REPETICIONES = 3;
+
+struct SesionVieja {
+    std::string correo;
+    std::string password;
+    std::chrono::system_clock::time_point creada_en;
+};
+size_t linearhash_extra_bytes(const SesionVieja& sesion) {
+    return linearhash_extra_bytes(sesion.correo) + linearhash_extra_bytes(sesion.password);
+}
+
+struct Sesion {
+    uint32_t correo;
+    std::chrono::system_clock::time_point vence_en;
+};
+struct SesionFria {
+    std::string password;
+};
+size_t linearhash_extra_bytes(const SesionFria& fria) {return linearhash_extra_bytes(fria.password);}
+
+template<typename F>
+double medir_ns(size_t ops, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / double(ops);
+}
+
+template<typename TV>
+double medir_get(LinearHash<SessionId, TV, SessionIdHasher>& tabla, const std::vector<SessionId>& consultas, size_t& control) {
+    double mejor = 1e18;
+    TV sesion;
+    for (int r = 0; r < REPETICIONES; ++r) {
+        mejor = std::min(mejor, medir_ns(consultas.size(), [&] {
+            for (const SessionId& token : consultas) control += tabla.try_get(token, sesion);
+        }));
+    }
+    return mejor;
+}
+
+void fila(const char* nombre, double tabla, double frios, double correos, double get_ns) {
+    cout << left << setw(10) << nombre << right << fixed << setprecision(1) << setw(10) << tabla << setw(10) << frios
+         << setw(10) << correos << setw(10) << tabla + frios + correos << setw(10) << get_ns << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t usuarios = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t por_usuario = argc > 2 ? std::stoul(argv[2]) : 5;
+    std::mt19937_64 rng(42);
+    // Sesiones mezcladas entre usuarios, como llegan los logins
+    std::vector<size_t> duenos;
+    for (size_t u = 0; u < usuarios; ++u)
+        for (size_t s = 0; s < por_usuario; ++s) duenos.push_back(u);
+    std::shuffle(duenos.begin(), duenos.end(), rng);
+    std::vector<SessionId> tokens(duenos.size());
+    mint_session_ids(tokens);
+    std::vector<SessionId> consultas = tokens;
+    std::shuffle(consultas.begin(), consultas.end(), rng);
+    auto correo_de = [](size_t u) {return "usuario" + std::to_string(u) + "@empresa-de-prueba.com";};
+    auto password_de = [](size_t u) {return "clave" + std::to_string(u);};
+    auto ahora = std::chrono::system_clock::now();
+    size_t control = 0;
+    double n = double(tokens.size());
+
+    cout << tokens.size() << " sesiones de " << usuarios << " usuarios, bytes por sesion y ns por get (mejor de "
+         << REPETICIONES << ")\n";
+    cout << left << setw(10) << "sesion" << right << setw(10) << "tabla" << setw(10) << "frios" << setw(10) << "correos"
+         << setw(10) << "total" << setw(10) << "get" << "\n";
+    {
+        LinearHash<SessionId, SesionVieja, SessionIdHasher> tabla(4);
+        tabla.set_budget({0, ~size_t(0)});   // sin límite real: solo para que lleve la cuenta de bytes
+        for (size_t k = 0; k < tokens.size(); ++k)
+            tabla.try_emplace(tokens[k], SesionVieja{correo_de(duenos[k]), password_de(duenos[k]), ahora});
+        fila("antes", double(tabla.memory_bytes()) / n, 0, 0, medir_get(tabla, consultas, control));
+    }
+    {
+        StringInternPool correos;
+        LinearHash<SessionId, Sesion, SessionIdHasher> tabla(4);
+        LinearHash<SessionId, SesionFria, SessionIdHasher> frios(4);
+        tabla.set_budget({0, ~size_t(0)});
+        frios.set_budget({0, ~size_t(0)});
+        for (size_t k = 0; k < tokens.size(); ++k) {
+            tabla.try_emplace(tokens[k], Sesion{correos.intern(correo_de(duenos[k])), ahora});
+            frios.try_emplace(tokens[k], SesionFria{password_de(duenos[k])});
+        }
+        double get_ns = medir_get(tabla, consultas, control);
+        fila("compacta", double(tabla.memory_bytes()) / n, double(frios.memory_bytes()) / n,
+             double(correos.memory_bytes()) / n, get_ns);
+    }
+    cout << "(" << control % 10 << ")\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Benchmark: claves string ("<ticks>_<random>", ~40 bytes, LinearHashFastHasher) vs.
+// SessionId (16 bytes dentro del nodo, SessionIdHasher) en la tabla de sesiones.
+// Uso: bench_sessionid [sesiones]   (por defecto 2000000)
+// Por cada tipo de clave: bytes por sesión (estimación de la tabla: nodo + memoria dinámica
+// de clave y valor), ns por insert / get, y get desde el texto del token (para SessionId,
+// parse_session_id + get: lo que paga de verdad un request). "texto" mide gets
+// independientes (el procesador solapa varios a la vez); "latencia" encadena cada get con
+// el anterior, como un request que hace uno solo.
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "../linearhash.h"
+#include "../sessionid.h"
+
+const int REPETICIONES = 3;
+
+template<typename F>
+double medir_ns(size_t ops, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / double(ops);
+}
+
+// "textos" son los tokens tal como llegan en los requests; "claves" lo que se guarda en la tabla.
+// Las consultas se copian en orden aleatorio: la tabla se recorre al azar, pero el texto de
+// cada consulta se lee en orden (como el de un request, que ya está en caché).
+// "consultar" hace el get a partir del texto
+template<typename TK, typename Hash, typename Consulta>
+void correr(const char* nombre, const std::vector<TK>& claves, const std::vector<std::string>& textos, Consulta consultar) {
+    std::string correo = "usuario.de.prueba@test.com";
+    size_t control = 0;
+    double insert_ns = 1e18, get_ns = 1e18, texto_ns = 1e18, latencia_ns = 1e18, bytes = 0;
+    std::vector<size_t> orden(claves.size());
+    for (size_t k = 0; k < orden.size(); ++k) orden[k] = k;
+    std::shuffle(orden.begin(), orden.end(), std::mt19937_64(1));
+    std::vector<TK> consultas;
+    std::vector<std::string> consultas_texto;
+    for (size_t k : orden) {
+        consultas.push_back(claves[k]);
+        consultas_texto.push_back(textos[k]);
+    }
+    for (int r = 0; r < REPETICIONES; ++r) {
+        LinearHash<TK, std::string, Hash> tabla(4);
+        tabla.set_budget({0, ~size_t(0)});   // sin límite real: solo para que lleve la cuenta de bytes
+        insert_ns = std::min(insert_ns, medir_ns(claves.size(), [&] {for (const TK& clave : claves) tabla.insert(clave, correo);}));
+        bytes = double(tabla.memory_bytes()) / tabla.size();
+        std::string valor;
+        get_ns = std::min(get_ns, medir_ns(orden.size(), [&] {
+            for (const TK& clave : consultas) control += tabla.try_get(clave, valor);
+        }));
+        texto_ns = std::min(texto_ns, medir_ns(orden.size(), [&] {
+            for (const std::string& texto : consultas_texto) control += consultar(tabla, texto, valor);
+        }));
+        // El índice de la próxima consulta depende del valor leído (el desplazamiento siempre es 0)
+        latencia_ns = std::min(latencia_ns, medir_ns(consultas_texto.size(), [&] {
+            for (size_t k = 0; k < consultas_texto.size(); ++k) {
+                control += consultar(tabla, consultas_texto[k], valor);
+                k += valor.size() >> 20;
+            }
+        }));
+    }
+    cout << left << setw(12) << nombre << right << fixed << setprecision(1)
+         << setw(12) << bytes << setw(9) << insert_ns << setw(9) << get_ns << setw(9) << texto_ns << setw(10) << latencia_ns
+         << "   (" << control % 10 << ")\n";
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    std::mt19937_64 rng(42);
+    std::vector<SessionId> ids;
+    std::vector<std::string> textos;
+    ids.reserve(n); textos.reserve(n);
+    for (size_t k = 0; k < n; ++k) {
+        ids.push_back(SessionId{uint64_t(std::chrono::system_clock::now().time_since_epoch().count()), rng()});
+        textos.push_back(to_string(ids.back()));
+    }
+    cout << n << " sesiones, ns por operacion, mejor de " << REPETICIONES << "\n";
+    cout << left << setw(12) << "clave" << right << setw(12) << "bytes/ses" << setw(9) << "insert" << setw(9) << "get"
+         << setw(9) << "texto" << setw(10) << "latencia" << "\n";
+    // Con claves string el texto ya es la clave: get (texto) es el mismo get
+    correr<std::string, LinearHashFastHasher>("string", textos, textos,
+        [](auto& tabla, const std::string& texto, std::string& valor) {return tabla.try_get(texto, valor);});
+    correr<SessionId, SessionIdHasher>("SessionId", ids, textos,
+        [](auto& tabla, const std::string& texto, std::string& valor) {
+            SessionId clave;
+            return parse_session_id(texto, clave) && tabla.try_get(clave, valor);
+        });
+    return 0;
+}
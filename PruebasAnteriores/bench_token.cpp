@@ -0,0 +1,87 @@
+// Benchmark: emisión de tokens por segundo y por núcleo.
+// Uso: bench_token [tokens] [hilos]   (por defecto 1000000 tokens por hilo, 1 hilo)
+//  - viejo:   el generar_token() original, random_device + mt19937_64 nuevos por token y
+//             el resultado como string "<ticks>_<random>"
+//  - rd:      lo mismo pero devolviendo SessionId (sin armar el string)
+//  - chacha:  mint_session_id(), el ChaCha20 del hilo (tokenrng.h)
+//  - lote:    mint_session_ids() de a 1024
+// Con varios hilos cada uno emite "tokens" y se informa el promedio por hilo.
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../sessionid.h"
+
+const int REPETICIONES = 3;
+const size_t LOTE = 1024;
+
+std::string token_viejo() {
+    auto now = std::chrono::system_clock::now().time_since_epoch().count();
+    std::mt19937_64 rng(std::random_device{}());
+    uint64_t r = rng();
+    return std::to_string(now) + "_" + std::to_string(r);
+}
+
+SessionId token_random_device() {
+    auto now = std::chrono::system_clock::now().time_since_epoch().count();
+    std::mt19937_64 rng(std::random_device{}());
+    return SessionId{uint64_t(now), rng()};
+}
+
+// Tokens por segundo de cada hilo (promedio entre hilos, mejor de REPETICIONES)
+template<typename F>
+double medir(size_t tokens, unsigned hilos, F emitir) {
+    double mejor = 0;
+    for (int r = 0; r < REPETICIONES; ++r) {
+        std::vector<double> segundos(hilos);
+        std::vector<std::thread> workers;
+        for (unsigned h = 0; h < hilos; ++h) {
+            workers.emplace_back([&, h] {
+                uint64_t control = 0;
+                auto t0 = std::chrono::steady_clock::now();
+                emitir(tokens, control);
+                segundos[h] = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                if (control == 42) std::cout << "";   // que el compilador no descarte el trabajo
+            });
+        }
+        for (auto& w : workers) w.join();
+        double promedio = 0;
+        for (double s : segundos) promedio += double(tokens) / s;
+        mejor = std::max(mejor, promedio / hilos);
+    }
+    return mejor;
+}
+
+int main(int argc, char** argv) {
+    size_t tokens = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    unsigned hilos = argc > 2 ? unsigned(std::stoul(argv[2])) : 1;
+    // random_device es mucho más lento: se mide con menos tokens
+    size_t pocos = std::max<size_t>(1, tokens / 20);
+    std::cout << hilos << " hilo(s), tokens por segundo por hilo, mejor de " << REPETICIONES << "\n";
+    auto fila = [](const char* nombre, double por_segundo, double base) {
+        std::cout << std::left << std::setw(10) << nombre << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << por_segundo << std::setprecision(1) << std::setw(9) << por_segundo / base << "x\n";
+    };
+    double viejo = medir(pocos, hilos, [](size_t n, uint64_t& control) {
+        for (size_t k = 0; k < n; ++k) control += token_viejo().size();
+    });
+    fila("viejo", viejo, viejo);
+    fila("rd", medir(pocos, hilos, [](size_t n, uint64_t& control) {
+        for (size_t k = 0; k < n; ++k) control += token_random_device().lo;
+    }), viejo);
+    fila("chacha", medir(tokens, hilos, [](size_t n, uint64_t& control) {
+        for (size_t k = 0; k < n; ++k) control += mint_session_id().lo;
+    }), viejo);
+    fila("lote", medir(tokens, hilos, [](size_t n, uint64_t& control) {
+        std::vector<SessionId> lote(LOTE);
+        for (size_t k = 0; k < n; k += LOTE) {
+            mint_session_ids(lote);
+            control += lote[0].lo;
+        }
+    }), viejo);
+    return 0;
+}
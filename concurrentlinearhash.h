@@ -0,0 +1,468 @@
+#ifndef CONCURRENTLINEARHASH_H
+#define CONCURRENTLINEARHASH_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "linearhash.h"
+#include "epoch.h"
+
+// Linear Hashing concurrente: escritores con locks por franjas (lock striping),
+// lectores (try_get / contains / operator[]) sin ningún lock.
+//  - Cada bucket b se protege con el mutex stripes[b % nstripes]: escrituras sobre
+//    buckets de franjas distintas corren en paralelo.
+//  - El par (i, p) se publica en un único atómico "state". Un escritor calcula el índice
+//    con el state actual, toma el lock de esa franja y vuelve a calcular el índice:
+//    si no cambió, el bucket es el correcto (ver lock_bucket).
+//  - split() y merge() se serializan con resize_mutex y además toman las franjas de
+//    los dos buckets que tocan antes de mover nodos y publicar el nuevo state.
+//  - Lectores: cada bucket tiene un contador de versión (impar = escritura en curso).
+//    El lector lee versión, recorre la cadena y vuelve a mirar versión y state; si algo
+//    cambió (por ejemplo un split movió nodos a otro bucket) reintenta.
+//  - Un nodo publicado nunca se modifica: actualizar un valor = enlazar un nodo nuevo en
+//    su lugar. Los nodos desenlazados se retiran al EpochDomain y se liberan cuando ningún
+//    lector fijado pueda estar leyéndolos (split/merge/remove nunca hacen delete directo).
+//  - El directorio es un arreglo fijo de segmentos (nunca se realoja), así que un
+//    bucket ya publicado no cambia de dirección. Los segmentos no se liberan al
+//    hacer merge (quedan para el próximo crecimiento) sino en el destructor.
+
+// Nodo inmutable una vez publicado: solo "next" cambia (split/merge/remove)
+template<typename TK, typename TV>
+struct ConcurrentLinearHashNode {
+	const TK key; const TV value;
+	const size_t hash;
+	std::atomic<ConcurrentLinearHashNode*> next;
+	template<typename K, typename... Args>
+	ConcurrentLinearHashNode(size_t hash, K&& key, Args&&... args):
+		key(std::forward<K>(key)), value(std::forward<Args>(args)...), hash(hash), next(nullptr) {}
+};
+
+template<typename Node>
+struct ConcurrentLinearHashSegment {
+	static constexpr int shift = LinearHashSegment<Node>::shift;
+	static constexpr int size = LinearHashSegment<Node>::size;
+	std::atomic<Node*> heads[size];          // leídas por lectores sin lock
+	std::atomic<uint32_t> versions[size];    // seqlock por bucket
+	Node* tails[size];                       // solo con la franja tomada
+	int sizes[size];
+};
+
+template<typename TK, typename TV>
+class ConcurrentLinearHash {
+	typedef ConcurrentLinearHashNode<TK, TV> Node;
+	typedef ConcurrentLinearHashSegment<Node> Segment;
+
+	// Máximo de segmentos: 2^16 * 256 = 16M buckets. Al llegar al tope se deja de hacer split.
+	static constexpr size_t max_segments = size_t(1) << 16;
+
+	struct alignas(64) Stripe {
+		std::mutex mutex;
+	};
+
+	std::unique_ptr<std::atomic<Segment*>[]> segments;
+	std::unique_ptr<Stripe[]> stripes;
+	size_t stripe_mask;
+	// (i << 32) | p
+	std::atomic<uint64_t> state;
+	std::atomic<long long> datacount;
+	std::mutex resize_mutex;   // serializa split/merge/clear y los recorridos completos
+	EpochDomain epochs;        // nodos retirados esperando que no queden lectores
+	LinearHashHasher<TK> hasher;
+	int M0;
+
+	static uint64_t pack(uint64_t level, uint64_t split) {return (level << 32) | split;}
+	static int level_of(uint64_t s) {return int(s >> 32);}
+	static size_t split_of(uint64_t s) {return size_t(s & 0xffffffffu);}
+	size_t bucketcount_of(uint64_t s) const {return (size_t(M0) << level_of(s)) + split_of(s);}
+
+	size_t index_for(size_t h, uint64_t s) const {
+		size_t L = size_t(M0) << level_of(s);
+		size_t currindex = h % L;
+		if (currindex < split_of(s)) return h % (2 * L);
+		return currindex;
+	}
+	std::mutex& stripe_for(size_t index) {return stripes[index & stripe_mask].mutex;}
+
+	Segment* segment_of(size_t b) {return segments[b >> Segment::shift].load(std::memory_order_acquire);}
+	std::atomic<Node*>& head(size_t b) {return segment_of(b)->heads[b & (Segment::size - 1)];}
+	std::atomic<uint32_t>& version(size_t b) {return segment_of(b)->versions[b & (Segment::size - 1)];}
+	Node*& tail(size_t b) {return segment_of(b)->tails[b & (Segment::size - 1)];}
+	int& bsize(size_t b) {return segment_of(b)->sizes[b & (Segment::size - 1)];}
+
+	// Se asegura de que exista el segmento del bucket b (solo con resize_mutex tomado)
+	bool ensure_segment(size_t b) {
+		size_t seg = b >> Segment::shift;
+		if (seg >= max_segments) return false;
+		if (segments[seg].load(std::memory_order_relaxed) == nullptr)
+			segments[seg].store(new Segment(), std::memory_order_release);
+		return true;
+	}
+
+	// Toma el lock de la franja del bucket que corresponde a "h" con el state vigente
+	std::unique_lock<std::mutex> lock_bucket(size_t h, size_t& index) {
+		for (;;) {
+			index = index_for(h, state.load(std::memory_order_acquire));
+			std::unique_lock<std::mutex> lock(stripe_for(index));
+			if (index_for(h, state.load(std::memory_order_acquire)) == index) return lock;
+		}
+	}
+
+	// Marca una escritura sobre un bucket (versión impar mientras dura)
+	struct BucketWrite {
+		std::atomic<uint32_t>& v;
+		explicit BucketWrite(std::atomic<uint32_t>& v): v(v) {
+			v.store(v.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+		~BucketWrite() {v.store(v.load(std::memory_order_relaxed) + 1, std::memory_order_release);}
+	};
+
+	// Búsqueda sin locks. fn(node) se llama con el nodo encontrado (o nullptr)
+	// dentro de la lectura validada; lo que haga fn debe ser solo lectura.
+	template<typename K, typename Fn>
+	auto read_bucket(size_t h, const K& key, Fn fn) {
+		auto guard = epochs.pin();
+		for (;;) {
+			uint64_t s = state.load(std::memory_order_acquire);
+			size_t index = index_for(h, s);
+			std::atomic<uint32_t>& ver = version(index);
+			uint32_t v = ver.load(std::memory_order_acquire);
+			if (v & 1) {std::this_thread::yield(); continue;}   // escritura en curso sobre este bucket
+			Node* found = nullptr;
+			for (Node* current = head(index).load(std::memory_order_acquire); current != nullptr;
+				 current = current->next.load(std::memory_order_acquire)) {
+				if (current->hash == h && current->key == key) {found = current; break;}
+			}
+			auto result = fn(found);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (ver.load(std::memory_order_relaxed) == v &&
+				index_for(h, state.load(std::memory_order_relaxed)) == index) return result;
+		}
+	}
+
+	// Busca con la franja tomada: devuelve el nodo y su anterior en la cadena
+	template<typename K>
+	Node* find_locked(size_t index, size_t h, const K& key, Node*& prev) {
+		prev = nullptr;
+		for (Node* current = head(index).load(std::memory_order_relaxed); current != nullptr;
+			 current = current->next.load(std::memory_order_relaxed)) {
+			if (current->hash == h && current->key == key) return current;
+			prev = current;
+		}
+		return nullptr;
+	}
+
+	// Enlaza al inicio del bucket (con su franja tomada)
+	void link_front(size_t index, Node* node) {
+		BucketWrite write(version(index));
+		Node* first = head(index).load(std::memory_order_relaxed);
+		node->next.store(first, std::memory_order_relaxed);
+		if (first == nullptr) tail(index) = node;
+		head(index).store(node, std::memory_order_release);
+		++bsize(index);
+		datacount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Desenlaza "node" (con la franja tomada) y lo retira; se libera cuando sea seguro
+	void unlink(size_t index, Node* prev, Node* node) {
+		{
+			BucketWrite write(version(index));
+			Node* next = node->next.load(std::memory_order_relaxed);
+			if (prev == nullptr) head(index).store(next, std::memory_order_release);
+			else prev->next.store(next, std::memory_order_release);
+			if (tail(index) == node) tail(index) = prev;
+			--bsize(index);
+		}
+		datacount.fetch_sub(1, std::memory_order_relaxed);
+		epochs.retire(node);
+	}
+
+	// Lock de las franjas de dos buckets en orden fijo (una sola vez si coinciden)
+	struct PairLock {
+		std::unique_lock<std::mutex> first, second;
+		PairLock(std::mutex& a, std::mutex& b) {
+			if (&a == &b) {first = std::unique_lock<std::mutex>(a); return;}
+			std::mutex* lo = &a < &b ? &a : &b;
+			std::mutex* hi = &a < &b ? &b : &a;
+			first = std::unique_lock<std::mutex>(*lo);
+			second = std::unique_lock<std::mutex>(*hi);
+		}
+	};
+
+	bool over_max_load() {
+		return double(datacount.load(std::memory_order_relaxed)) /
+			bucketcount_of(state.load(std::memory_order_relaxed)) > maxFillFactor;
+	}
+	bool under_min_load() {
+		uint64_t s = state.load(std::memory_order_relaxed);
+		return bucketcount_of(s) > size_t(M0) &&
+			double(datacount.load(std::memory_order_relaxed)) / bucketcount_of(s) < lowerBound;
+	}
+
+	void maybe_split() {
+		if (!over_max_load()) return;
+		std::lock_guard<std::mutex> resize(resize_mutex);
+		if (over_max_load()) split_locked();
+	}
+	void maybe_merge() {
+		if (!under_min_load()) return;
+		std::lock_guard<std::mutex> resize(resize_mutex);
+		if (under_min_load()) merge_locked();
+	}
+
+public:
+	// M0: buckets iniciales; stripes: cantidad de franjas de locks (se redondea a potencia de 2)
+	ConcurrentLinearHash(int M0=4, size_t stripe_count=64):
+	segments(new std::atomic<Segment*>[max_segments]), state(pack(0, 0)), datacount(0), M0(M0) {
+		size_t n = 1;
+		while (n < stripe_count) n <<= 1;
+		stripes.reset(new Stripe[n]);
+		stripe_mask = n - 1;
+		for (size_t s = 0; s < max_segments; ++s) segments[s].store(nullptr, std::memory_order_relaxed);
+		for (size_t b = 0; b < size_t(M0); ++b) ensure_segment(b);
+	}
+	ConcurrentLinearHash(const ConcurrentLinearHash&) = delete;
+	ConcurrentLinearHash& operator=(const ConcurrentLinearHash&) = delete;
+
+	int size() {return int(datacount.load(std::memory_order_relaxed));}
+	int bucket_count() {return int(bucketcount_of(state.load(std::memory_order_acquire)));}
+
+	template<typename K, typename V>
+	void insert(K&& key, V&& value) {insert_or_assign(std::forward<K>(key), std::forward<V>(value));}
+
+	// Devuelven true si se insertó un nodo nuevo
+	template<typename K, typename... Args>
+	bool try_emplace(K&& key, Args&&... args) {
+		size_t h = hasher(key);
+		{
+			size_t index;
+			auto lock = lock_bucket(h, index);
+			Node* prev;
+			if (find_locked(index, h, key, prev) != nullptr) return false;
+			link_front(index, new Node(h, std::forward<K>(key), std::forward<Args>(args)...));
+		}
+		maybe_split();
+		return true;
+	}
+
+	// Si la clave existe, su nodo se reemplaza por uno nuevo con el valor (el viejo se retira)
+	template<typename K, typename V>
+	bool insert_or_assign(K&& key, V&& value) {
+		size_t h = hasher(key);
+		{
+			size_t index;
+			auto lock = lock_bucket(h, index);
+			Node* prev;
+			if (Node* found = find_locked(index, h, key, prev)) {
+				Node* replacement = new Node(h, found->key, std::forward<V>(value));
+				{
+					BucketWrite write(version(index));
+					replacement->next.store(found->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					if (prev == nullptr) head(index).store(replacement, std::memory_order_release);
+					else prev->next.store(replacement, std::memory_order_release);
+					if (tail(index) == found) tail(index) = replacement;
+				}
+				epochs.retire(found);
+				return false;
+			}
+			link_front(index, new Node(h, std::forward<K>(key), std::forward<V>(value)));
+		}
+		maybe_split();
+		return true;
+	}
+
+	// Sin locks: el valor se copia desde un nodo inmutable protegido por la época
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	bool try_get(const K& key, TV &out_value) {
+		return read_bucket(hasher(key), key, [&](Node* found) {
+			if (found == nullptr) return false;
+			out_value = found->value;
+			return true;
+		});
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	TV operator[](const K& key) {
+		TV value;
+		if (!try_get(key, value)) throw std::runtime_error("Key not found in linear hashing");
+		return value;
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	bool contains(const K& key) {
+		return read_bucket(hasher(key), key, [](Node* found) {return found != nullptr;});
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	bool remove(const K& key) {
+		size_t h = hasher(key);
+		{
+			size_t index;
+			auto lock = lock_bucket(h, index);
+			Node* prev;
+			Node* found = find_locked(index, h, key, prev);
+			if (found == nullptr) return false;
+			unlink(index, prev, found);
+		}
+		maybe_merge();
+		return true;
+	}
+
+	// Borra todo: bloquea splits/merges y todas las franjas; los nodos se retiran
+	void clear() {
+		std::lock_guard<std::mutex> resize(resize_mutex);
+		std::vector<std::unique_lock<std::mutex>> locks;
+		for (size_t s = 0; s <= stripe_mask; ++s) locks.emplace_back(stripes[s].mutex);
+		size_t buckets = bucketcount_of(state.load(std::memory_order_relaxed));
+		for (size_t b = 0; b < buckets; ++b) {
+			Node* curr;
+			{
+				BucketWrite write(version(b));
+				curr = head(b).exchange(nullptr, std::memory_order_acq_rel);
+				tail(b) = nullptr; bsize(b) = 0;
+			}
+			while (curr != nullptr) {
+				Node* temp = curr;
+				curr = curr->next.load(std::memory_order_relaxed);
+				epochs.retire(temp);
+			}
+		}
+		datacount.store(0, std::memory_order_relaxed);
+	}
+
+	// Recorre bucket por bucket (cada uno con su franja tomada) y borra en el mismo
+	// recorrido los elementos para los que callback(key, value) devuelve true.
+	// Mientras dura no hay splits/merges; los merges pendientes se hacen al final.
+	template<typename Func>
+	LinearHashSweepResult for_each_remove_if(Func callback) {
+		std::lock_guard<std::mutex> resize(resize_mutex);
+		LinearHashSweepResult result;
+		size_t buckets = bucketcount_of(state.load(std::memory_order_relaxed));
+		for (size_t b = 0; b < buckets; ++b) {
+			std::lock_guard<std::mutex> lock(stripe_for(b));
+			Node* prev = nullptr;
+			Node* curr = head(b).load(std::memory_order_relaxed);
+			while (curr != nullptr) {
+				Node* next = curr->next.load(std::memory_order_relaxed);
+				if (callback(curr->key, curr->value)) {
+					unlink(b, prev, curr);
+					++result.removed;
+				} else prev = curr;
+				curr = next;
+			}
+		}
+		while (under_min_load()) {
+			merge_locked();
+			++result.merges;
+		}
+		return result;
+	}
+
+	void debug_print(const char* label = "") {
+		std::lock_guard<std::mutex> resize(resize_mutex);
+		uint64_t s = state.load(std::memory_order_relaxed);
+		size_t buckets = bucketcount_of(s);
+		cout << "\n========== ESTADO ConcurrentLinearHash " << label << " ==========\n";
+		cout << "M0=" << M0
+			 << "  i=" << level_of(s)
+			 << "  p=" << split_of(s)
+			 << "  bucketcount=" << buckets
+			 << "  stripes=" << stripe_mask + 1
+			 << "  datacount=" << datacount.load(std::memory_order_relaxed)
+			 << "  fillFactor=" << double(datacount.load(std::memory_order_relaxed)) / buckets
+			 << "  retirados=" << epochs.pending()
+			 << "\n";
+		for (size_t b = 0; b < buckets; ++b) {
+			std::lock_guard<std::mutex> lock(stripe_for(b));
+			cout << "Bucket " << b << " (size=" << bsize(b) << "): ";
+			Node* curr = head(b).load(std::memory_order_relaxed);
+			if (!curr) cout << "[vacio]";
+			while (curr) {
+				cout << curr->key;
+				curr = curr->next.load(std::memory_order_relaxed);
+				if (curr) cout << " -> ";
+			}
+			cout << "\n";
+		}
+		cout << "===========================================\n";
+	}
+
+private:
+	// Split del bucket p (con resize_mutex tomado). Se toman las franjas de p y del
+	// bucket nuevo; ambos quedan con versión impar hasta publicar el nuevo state.
+	void split_locked() {
+		uint64_t s = state.load(std::memory_order_relaxed);
+		int level = level_of(s);
+		size_t p = split_of(s);
+		size_t L = size_t(M0) << level;
+		size_t newindex = p + L;
+		if (!ensure_segment(newindex)) return;
+		PairLock locks(stripe_for(p), stripe_for(newindex));
+		BucketWrite write_old(version(p));
+		BucketWrite write_new(version(newindex));
+		Node* currnode = head(p).load(std::memory_order_relaxed);
+		Node* prevnode = nullptr;
+		while (currnode != nullptr) {
+			Node* nextnode = currnode->next.load(std::memory_order_relaxed);
+			if (currnode->hash % (2 * L) != p) {
+				if (prevnode != nullptr) prevnode->next.store(nextnode, std::memory_order_release);
+				else head(p).store(nextnode, std::memory_order_release);
+				Node* first = head(newindex).load(std::memory_order_relaxed);
+				if (first == nullptr) tail(newindex) = currnode;
+				currnode->next.store(first, std::memory_order_release);
+				head(newindex).store(currnode, std::memory_order_release);
+				++bsize(newindex); --bsize(p);
+			} else prevnode = currnode;
+			currnode = nextnode;
+		}
+		tail(p) = prevnode;
+		++p;
+		if (p == L) {++level; p = 0;}
+		state.store(pack(level, p), std::memory_order_release);
+	}
+
+	// Merge del último bucket sobre p-1 (con resize_mutex tomado)
+	void merge_locked() {
+		uint64_t s = state.load(std::memory_order_relaxed);
+		int level = level_of(s);
+		size_t p = split_of(s);
+		if (p == 0) {--level; p = (size_t(M0) << level) - 1;}
+		else --p;
+		size_t last = bucketcount_of(s) - 1;
+		PairLock locks(stripe_for(p), stripe_for(last));
+		BucketWrite write_target(version(p));
+		BucketWrite write_last(version(last));
+		bsize(p) += bsize(last); bsize(last) = 0;
+		Node* moved = head(last).load(std::memory_order_relaxed);
+		if (moved != nullptr) {
+			if (head(p).load(std::memory_order_relaxed) == nullptr) head(p).store(moved, std::memory_order_release);
+			else tail(p)->next.store(moved, std::memory_order_release);
+			tail(p) = tail(last);
+		}
+		head(last).store(nullptr, std::memory_order_release); tail(last) = nullptr;
+		state.store(pack(level, p), std::memory_order_release);
+	}
+
+public:
+	~ConcurrentLinearHash() {
+		for (size_t seg = 0; seg < max_segments; ++seg) {
+			Segment* segment = segments[seg].load(std::memory_order_relaxed);
+			if (segment == nullptr) continue;
+			for (int b = 0; b < Segment::size; ++b) {
+				Node* curr = segment->heads[b].load(std::memory_order_relaxed);
+				while (curr != nullptr) {
+					Node* temp = curr;
+					curr = curr->next.load(std::memory_order_relaxed);
+					delete temp;
+				}
+			}
+			delete segment;
+		}
+	}
+};
+
+#endif //CONCURRENTLINEARHASH_H
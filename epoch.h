@@ -0,0 +1,161 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// Reclamación de memoria por épocas (epoch-based reclamation, EBR).
+// Los lectores "fijan" la época global mientras recorren la estructura sin locks;
+// los escritores no liberan un nodo desenlazado, lo "retiran" con la época actual.
+// Un nodo retirado en la época e se libera recién cuando la época global llega a e + 2:
+// para entonces ningún lector que pudiera verlo sigue fijado.
+
+// Índice pequeño y estable por hilo (0..max_threads-1), compartido por todos los dominios.
+// Se recicla cuando el hilo termina.
+class EpochThreadRegistry {
+public:
+	static constexpr int max_threads = 256;
+
+	static int slot() {
+		thread_local Handle handle;
+		return handle.id;
+	}
+
+	// Cota de los índices entregados hasta ahora: quien recorre los slots de todos los hilos
+	// mira solo [0, thread_count()) en lugar de los max_threads
+	static int thread_count() {return registry().next_id.load();}
+
+private:
+	struct Registry {
+		std::mutex mutex;
+		std::vector<int> free_ids;
+		std::atomic<int> next_id{0};   // se escribe con mutex; se lee sin él (thread_count)
+	};
+	static Registry& registry() {
+		static Registry instance;
+		return instance;
+	}
+	struct Handle {
+		int id;
+		Handle() {
+			Registry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			if (!r.free_ids.empty()) {id = r.free_ids.back(); r.free_ids.pop_back();}
+			else if (r.next_id.load(std::memory_order_relaxed) < max_threads) id = r.next_id.fetch_add(1);
+			else throw std::runtime_error("EpochThreadRegistry: too many threads");
+		}
+		~Handle() {
+			Registry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			r.free_ids.push_back(id);
+		}
+	};
+};
+
+// Cada hilo retira en su propio slot (una lista que solo toca él) y libera su propia lista:
+// retirar no toma ningún lock compartido, así que escritores de franjas distintas no se
+// serializan acá. Lo que deja un hilo que termina queda en su slot hasta que otro hilo
+// reciba ese índice (y lo libere como propio) o hasta el destructor del dominio.
+class EpochDomain {
+	static constexpr uint64_t idle = ~uint64_t(0);
+	// Cantidad de retiros acumulados (por hilo) antes de intentar avanzar la época y liberar
+	static constexpr size_t reclaim_threshold = 128;
+
+	struct Retired {
+		void* ptr;
+		void (*deleter)(void*);
+		uint64_t epoch;
+	};
+	struct alignas(64) Slot {
+		std::atomic<uint64_t> epoch{idle};
+		int depth = 0;                          // solo lo toca el hilo dueño (guards anidados)
+		std::vector<Retired> retired;           // solo lo toca el hilo dueño
+		std::atomic<size_t> retired_count{0};   // tamaño de retired, para pending()
+	};
+
+	std::atomic<uint64_t> global_epoch{0};
+	Slot slots[EpochThreadRegistry::max_threads];
+
+	// La época avanza solo si todos los hilos fijados ya vieron la actual
+	bool try_advance() {
+		uint64_t e = global_epoch.load();
+		int threads = EpochThreadRegistry::thread_count();
+		for (int t = 0; t < threads; ++t) {
+			uint64_t seen = slots[t].epoch.load();
+			if (seen != idle && seen != e) return false;
+		}
+		return global_epoch.compare_exchange_strong(e, e + 1);
+	}
+
+	// Libera lo que el hilo dueño de "slot" retiró hace al menos dos épocas
+	void reclaim(Slot& slot) {
+		try_advance();
+		uint64_t e = global_epoch.load();
+		size_t kept = 0;
+		for (Retired& item : slot.retired) {
+			if (item.epoch + 2 <= e) item.deleter(item.ptr);
+			else slot.retired[kept++] = item;
+		}
+		slot.retired.resize(kept);
+		slot.retired_count.store(kept, std::memory_order_relaxed);
+	}
+
+public:
+	EpochDomain() = default;
+	EpochDomain(const EpochDomain&) = delete;
+	EpochDomain& operator=(const EpochDomain&) = delete;
+
+	// Mientras exista, el hilo está fijado: nada de lo que pueda alcanzar se libera
+	class Guard {
+		EpochDomain& domain;
+		Slot& slot;
+	public:
+		explicit Guard(EpochDomain& domain): domain(domain), slot(domain.slots[EpochThreadRegistry::slot()]) {
+			if (slot.depth++ > 0) return;
+			// Publicar la época y confirmar que no cambió mientras se publicaba
+			uint64_t e = domain.global_epoch.load();
+			for (;;) {
+				slot.epoch.store(e);
+				uint64_t now = domain.global_epoch.load();
+				if (now == e) break;
+				e = now;
+			}
+		}
+		~Guard() {
+			if (--slot.depth == 0) slot.epoch.store(idle, std::memory_order_release);
+		}
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+	};
+
+	Guard pin() {return Guard(*this);}
+
+	// El objeto ya no es alcanzable desde la estructura: se liberará cuando sea seguro
+	template<typename T>
+	void retire(T* ptr) {
+		Slot& slot = slots[EpochThreadRegistry::slot()];
+		slot.retired.push_back({ptr, [](void* p) {delete static_cast<T*>(p);}, global_epoch.load()});
+		slot.retired_count.store(slot.retired.size(), std::memory_order_relaxed);
+		if (slot.retired.size() >= reclaim_threshold) reclaim(slot);
+	}
+
+	// Retirados que todavía no se liberaron (suma de todos los hilos, aproximada si hay
+	// retiros en curso)
+	size_t pending() {
+		size_t total = 0;
+		for (const Slot& slot : slots) total += slot.retired_count.load(std::memory_order_relaxed);
+		return total;
+	}
+
+	// Solo cuando ya no hay lectores (destructor de la estructura)
+	~EpochDomain() {
+		for (Slot& slot : slots) {
+			for (Retired& item : slot.retired) item.deleter(item.ptr);
+		}
+	}
+};
+
+#endif //EPOCH_H
@@ -0,0 +1,169 @@
+#ifndef INTERNPOOL_H
+#define INTERNPOOL_H
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "epoch.h"
+#include "shardedlinearhash.h"
+#include "linearhash_hash.h"
+
+// Pool de strings internados: cada texto distinto se guarda una sola vez y se identifica
+// con un uint32. Pensado para valores que se repiten mucho entre entradas de una tabla
+// (p. ej. el correo de las sesiones de un mismo usuario).
+//  - intern(texto): el id del texto, agregándolo si es nuevo, con una referencia más. Si ya
+//    está, solo lee el índice (ShardedLinearHash) y suma la referencia con un CAS; agregar
+//    uno nuevo toma además un mutex de altas.
+//  - release(id): suelta una referencia. Con la última el texto sale del índice y su lugar
+//    se recicla (lo reusa un intern posterior), así el pool guarda solo los textos que
+//    alguna entrada viva sigue usando, no todos los que pasaron.
+//  - view(id): el texto, sin locks. Los strings viven en bloques que no se mueven nunca
+//    (el bloque k tiene first_chunk << k lugares). Vale mientras quien lee tenga una
+//    referencia, o si fijó el pool (pin) antes de obtener el id: un lugar soltado se limpia
+//    y se reusa recién cuando ningún hilo fijado desde antes puede verlo (EpochDomain).
+// El índice texto -> id guarda string_view que apuntan a los mismos strings de los bloques.
+class StringInternPool {
+	static constexpr uint32_t first_chunk = 1024;
+	static constexpr int max_chunks = 22;   // 1024 * (2^22 - 1) ids: casi todo uint32
+
+	struct Entry {
+		std::string text;
+		std::atomic<uint32_t> refs{0};   // 0 = lugar libre (o soltado, esperando reciclarse)
+	};
+	// Lugar soltado: se recicla cuando EpochDomain lo libera (ningún lector fijado lo ve)
+	struct Released {
+		StringInternPool* pool;
+		uint32_t id;
+		~Released() {pool->recycle(id);}
+	};
+
+	std::atomic<Entry*> chunks[max_chunks] = {};
+	std::atomic<uint32_t> count{0};          // lugares usados alguna vez (los bloques llegan hasta acá)
+	std::atomic<uint32_t> live{0};           // textos internados con referencias
+	std::mutex append_mutex;
+	size_t text_bytes = 0;                   // memoria dinámica de los strings (bajo append_mutex)
+	std::vector<uint32_t> free_ids;          // lugares reciclados (bajo append_mutex)
+	ShardedLinearHash<std::string_view, uint32_t, LinearHashFastHasher> ids;
+	std::unique_ptr<EpochDomain> epochs = std::make_unique<EpochDomain>();
+
+	static int chunk_of(uint32_t id) {return std::bit_width(id / first_chunk + 1) - 1;}
+	static uint32_t chunk_start(int chunk) {return first_chunk * ((uint32_t(1) << chunk) - 1);}
+
+	Entry& entry(uint32_t id) const {
+		int chunk = chunk_of(id);
+		return chunks[chunk].load(std::memory_order_acquire)[id - chunk_start(chunk)];
+	}
+
+	// Suma una referencia solo si el texto sigue vivo (la última ya soltada no revive sin lock)
+	static bool acquire(Entry& stored) {
+		uint32_t refs = stored.refs.load(std::memory_order_relaxed);
+		while (refs != 0) {
+			if (stored.refs.compare_exchange_weak(refs, refs + 1)) return true;
+		}
+		return false;
+	}
+
+	void recycle(uint32_t id) {
+		std::lock_guard<std::mutex> lock(append_mutex);
+		Entry& stored = entry(id);
+		text_bytes -= linearhash_extra_bytes(stored.text);
+		std::string().swap(stored.text);
+		free_ids.push_back(id);
+	}
+
+public:
+	explicit StringInternPool(size_t shard_count = 16): ids(shard_count, 4) {}
+	StringInternPool(const StringInternPool&) = delete;
+	StringInternPool& operator=(const StringInternPool&) = delete;
+	~StringInternPool() {
+		// Primero los lugares soltados pendientes (recycle todavía usa los bloques)
+		epochs.reset();
+		for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+	}
+
+	uint32_t intern(std::string_view text) {
+		uint32_t id;
+		{
+			// Fijado: el id encontrado no se recicla para otro texto antes del acquire
+			auto guard = epochs->pin();
+			if (ids.try_get(text, id) && acquire(entry(id))) return id;
+		}
+		std::lock_guard<std::mutex> lock(append_mutex);
+		// Otro hilo pudo agregarlo entre la búsqueda y el lock (con el lock, si está en el
+		// índice tiene referencias: la última se suelta con este mismo lock)
+		if (ids.try_get(text, id)) {
+			entry(id).refs.fetch_add(1);
+			return id;
+		}
+		if (!free_ids.empty()) {
+			id = free_ids.back();
+			free_ids.pop_back();
+		} else {
+			id = count.load(std::memory_order_relaxed);
+			int chunk = chunk_of(id);
+			if (chunk >= max_chunks) throw std::length_error("StringInternPool: too many strings");
+			if (chunks[chunk].load(std::memory_order_relaxed) == nullptr)
+				chunks[chunk].store(new Entry[size_t(first_chunk) << chunk], std::memory_order_release);
+			count.store(id + 1, std::memory_order_release);
+		}
+		Entry& stored = entry(id);
+		stored.text.assign(text);
+		text_bytes += linearhash_extra_bytes(stored.text);
+		stored.refs.store(1, std::memory_order_relaxed);
+		live.fetch_add(1, std::memory_order_relaxed);
+		// Primero se escribe el string (view) y después se publica el id en el índice (intern)
+		ids.try_emplace(std::string_view(stored.text), id);
+		return id;
+	}
+
+	// Suelta una referencia de intern(). Con la última el texto sale del índice (un intern
+	// posterior lo vuelve a agregar) y su lugar se recicla cuando ningún lector fijado lo ve.
+	void release(uint32_t id) {
+		Entry& stored = entry(id);
+		// Mientras no sea la última, sin lock
+		uint32_t refs = stored.refs.load(std::memory_order_relaxed);
+		while (refs > 1) {
+			if (stored.refs.compare_exchange_weak(refs, refs - 1)) return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(append_mutex);
+			if (stored.refs.fetch_sub(1) != 1) return;
+			ids.remove(std::string_view(stored.text));
+			live.fetch_sub(1, std::memory_order_relaxed);
+		}
+		// Afuera del lock: retire puede reciclar en el acto (recycle lo toma)
+		epochs->retire(new Released{this, id});
+	}
+
+	// Mientras exista el guard, ningún id que el hilo obtenga (aunque otro lo suelte) se
+	// recicla: view sigue devolviendo su texto
+	EpochDomain::Guard pin() {return epochs->pin();}
+
+	// Busca sin agregar ni sumar referencias: false si el texto no está internado
+	bool find(std::string_view text, uint32_t& id) {return ids.try_get(text, id);}
+
+	// id tiene que haber salido de intern() de este pool (ver arriba cuándo vale el texto)
+	std::string_view view(uint32_t id) const {return entry(id).text;}
+
+	// Textos internados que tienen referencias
+	size_t size() const {return live.load(std::memory_order_relaxed);}
+
+	// Bytes de los bloques y de los textos (sin el índice)
+	size_t memory_bytes() {
+		std::lock_guard<std::mutex> lock(append_mutex);
+		size_t bytes = text_bytes + free_ids.capacity() * sizeof(uint32_t);
+		for (int chunk = 0; chunk < max_chunks; ++chunk) {
+			if (chunks[chunk].load(std::memory_order_relaxed) != nullptr)
+				bytes += (size_t(first_chunk) << chunk) * sizeof(Entry);
+		}
+		return bytes;
+	}
+};
+
+#endif //INTERNPOOL_H
@@ -1,6 +1,30 @@
+#ifndef LINEARHASH_H
+#define LINEARHASH_H
+
 #include <stdexcept>
 #include <iostream>
 #include <vector>
+#include <string>
+#include <string_view>
+#include <concepts>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <thread>
+#include "linearhash_alloc.h"
+#include "linearhash_stats.h"
+#include "linearhash_snapshot.h"
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
 
 using namespace std;
 
@@ -9,15 +33,84 @@ const float maxFillFactor = 0.75;
 // Límite inferior de factor de carga para empezar a hacer merge
 const float lowerBound = 0.4;
 
+// Hasher por defecto. Para std::string es "transparente" (is_transparent):
+// acepta std::string_view / const char* y da el mismo valor que std::hash<std::string>,
+// así una búsqueda no necesita construir un std::string temporal.
+template<typename TK>
+struct LinearHashHasher : std::hash<TK> {};
+
+template<>
+struct LinearHashHasher<std::string> {
+	using is_transparent = void;
+	size_t operator()(std::string_view key) const noexcept {return std::hash<std::string_view>{}(key);}
+};
+
+// Pide al procesador que traiga a caché la línea de "address" (solo una pista, no falla nunca)
+inline void linearhash_prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(address);
+#elif defined(_MSC_VER)
+	_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+	(void)address;
+#endif
+}
+
+// K sirve como clave de búsqueda si es TK, o si el hasher y la comparación son
+// transparentes (como en std::unordered_map), el hasher acepta K y K se compara con TK
+template<typename K, typename TK, typename Hash, typename KeyEqual = std::equal_to<>>
+concept LinearHashLookupKey = std::same_as<K, TK> ||
+	(requires {typename Hash::is_transparent; typename KeyEqual::is_transparent;} &&
+	 std::invocable<const Hash&, const K&> &&
+	 std::predicate<const KeyEqual&, const TK&, const K&>);
+
+// Resultado de for_each_remove_if: nodos borrados y merges hechos al final del recorrido
+struct LinearHashSweepResult {
+	int removed = 0;
+	int merges = 0;
+	LinearHashSweepResult& operator+=(const LinearHashSweepResult& other) {
+		removed += other.removed; merges += other.merges;
+		return *this;
+	}
+};
+
+// Presupuesto de memoria de la tabla (0 = sin límite). Cuando se pasa, se desalojan
+// entradas frías con CLOCK (ver LinearHash::set_budget).
+struct LinearHashBudget {
+	size_t max_entries = 0;
+	size_t max_bytes = 0;      // nodos + memoria dinámica de clave y valor (estimada)
+};
+
+// Memoria dinámica que ocupa un valor además de su sizeof (para el presupuesto en bytes).
+// Por defecto 0; std::string cuenta su buffer si no entra en el SSO. Para un tipo propio se
+// agrega una sobrecarga linearhash_extra_bytes(const Tipo&) en su namespace (se encuentra por ADL).
+template<typename T>
+size_t linearhash_extra_bytes(const T&) {return 0;}
+inline size_t linearhash_extra_bytes(const std::string& value) {
+	return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+}
+
 // Cada bucket es una lista enlazada de nodos LinearHashNode
 // TK = tipo de la clave (key), TV = tipo del valor (value)
 template <typename TK, typename TV>
 struct LinearHashNode {
 	TK key; TV value;   // string token y struct Sesion
+	size_t hash;        // hash completo de key, calculado una sola vez en insert
 	LinearHashNode* next;	// chaining
+	bool referenced = false;   // bit de acceso del CLOCK (solo importa con presupuesto)
 	LinearHashNode() = default;
-	LinearHashNode(TK key, TV value): key(key), value(value), next(nullptr) {}
-	LinearHashNode(TK key, TV value, LinearHashNode* next): key(key), value(value), next(next) {}
+	// Construye clave y valor en el lugar a partir de los argumentos recibidos (sin copias extra)
+	template<typename K, typename... Args>
+	LinearHashNode(size_t hash, K&& key, Args&&... args):
+		key(std::forward<K>(key)), value(std::forward<Args>(args)...), hash(hash), next(nullptr) {}
+};
+
+// Lo que da el iterador de toda la tabla: la clave solo se puede leer (cambiarla dejaría
+// el nodo en un bucket que no le corresponde) y el valor se puede modificar en el lugar
+template <typename TK, typename TV>
+struct LinearHashEntry {
+	const TK& key;
+	TV& value;
 };
 
 // Permite recorrer la lista enlazada de un bucket como si fuera un contenedor
@@ -40,169 +133,636 @@ public:
 };
 
 
-template<typename TK, typename TV>
+// Segmento del directorio de buckets: bloque fijo de buckets contiguos.
+// El directorio es una lista de segmentos; crecer = agregar un segmento,
+// decrecer = soltar el último. Ninguna cabeza de bucket se copia nunca.
+template<typename Node>
+struct LinearHashSegment {
+	static constexpr int shift = 8;
+	static constexpr int size = 1 << shift;   // buckets por segmento (potencia de 2)
+	Node* heads[size];   // primer nodo de cada bucket
+	Node* tails[size];   // último nodo de cada bucket (merge concatena en O(1))
+	int sizes[size];     // cantidad de elementos de cada bucket
+};
+
+// Hash: función de hash de la clave (por defecto LinearHashHasher = std::hash, transparente
+// para std::string; LinearHashFastHasher en linearhash_hash.h es más rápido para tokens).
+// KeyEqual: comparación de claves (por defecto std::equal_to<>, transparente).
+// Si los dos tienen is_transparent, las búsquedas aceptan claves de otro tipo (string_view).
+// NodeAlloc: política de asignación de nodos (ver linearhash_alloc.h)
+//  - LinearHashNewDeleteAllocator: new/delete por nodo (por defecto)
+//  - LinearHashPoolAllocator: slabs + free list, insert/remove sin malloc
+// Stats: política de estadísticas (ver linearhash_stats.h)
+//  - LinearHashNoStats: sin costo (por defecto, producción)
+//  - LinearHashFullStats: probes por operación, splits/merges y sus duraciones, por hilo
+template<typename TK, typename TV, typename Hash = LinearHashHasher<TK>, typename KeyEqual = std::equal_to<>,
+		 template<typename> class NodeAlloc = LinearHashNewDeleteAllocator, typename Stats = LinearHashNoStats>
 class LinearHash {
 	// Alias internos para simplificar código
 	typedef LinearHashNode<TK, TV> Node;
 	typedef LinearHashListIterator<TK, TV> Iterator;
+	typedef LinearHashSegment<Node> Segment;
 
-	Node** array;   // Arreglo de punteros a lista de nodos: los buckets físicos
-	int* bucket_sizes;   // Arreglo con la cantidad de elementos en cada bucket
-	int visited;   // Contador de nodos visitados (para estadísticas)
+	NodeAlloc<Node> alloc;   // de dónde salen (y a dónde vuelven) los nodos
+	Hash hasher;
+	[[no_unique_address]] KeyEqual key_equal;
+	// Directorio segmentado: el bucket b vive en segments[b / Segment::size], posición b % Segment::size
+	std::vector<Segment*> segments;
+	[[no_unique_address]] Stats stats;   // con LinearHashNoStats no ocupa lugar
 	// Parámetros y estado del Linear Hashing:
 	// M0: cantidad base de buckets (tamaño inicial)
 	// p:  índice del próximo bucket lógico a dividir (split pointer)
 	// i:  nivel de expansión (indica cuántas veces hemos duplicado la tabla)
 	// datacount: cantidad total de claves almacenadas
 	// bucketcount: número de buckets lógicos activos
-	// capacity: capacidad física del array (puede ser > bucketcount por splits/merges)
+	// capacity: buckets físicos reservados (segmentos * Segment::size, >= bucketcount)
 	int M0, p, i, datacount, bucketcount, capacity;
+	// Presupuesto (set_budget): budgeted = hay algún límite; bytes_used solo se lleva entonces.
+	// hand = bucket donde está la aguja del CLOCK.
+	LinearHashBudget budget;
+	bool budgeted = false;
+	size_t bytes_used = 0;
+	size_t hand = 0;
+	uint64_t evicted = 0;
+	std::function<void(const TK&, const TV&)> on_evict;
+	// Acceso a los datos del bucket b dentro de su segmento
+	Node*& head(size_t b) {return segments[b >> Segment::shift]->heads[b & (Segment::size - 1)];}
+	Node*& tail(size_t b) {return segments[b >> Segment::shift]->tails[b & (Segment::size - 1)];}
+	int& bsize(size_t b) {return segments[b >> Segment::shift]->sizes[b & (Segment::size - 1)];}
+	// Agrega segmentos (en cero) hasta que el bucket b tenga lugar
+	void grow_to(size_t b) {
+		while ((b >> Segment::shift) >= segments.size()) {
+			segments.push_back(new Segment());
+			capacity = int(segments.size()) * Segment::size;
+		}
+	}
+	// Suelta segmentos que quedaron sin buckets activos (se deja uno de reserva
+	// para no pedir/liberar un segmento en cada split/merge del borde)
+	void shrink_segments() {
+		size_t in_use = (size_t(bucketcount) + Segment::size - 1) >> Segment::shift;
+		while (segments.size() > in_use + 1) {
+			delete segments.back();
+			segments.pop_back();
+			capacity = int(segments.size()) * Segment::size;
+		}
+	}
 	double fillFactor(){
 		// Diferente a una tabla hash tradicional: aquí usamos bucketcount, no capacity
 		return double(datacount) / bucketcount;
 	}
 public:
 	//  M0: cantidad de buckets iniciales.
-	//  Se inicializa el array de buckets y el arreglo de tamaños en 0
-	// Inicializar todos los buckets apuntando a nullptr y tamaños en 0
-	LinearHash(int M0=4): M0(M0), array(new Node*[M0]()), bucket_sizes(new int[M0]()),
-	bucketcount(M0), p(0), i(0), datacount(0), capacity(M0), visited(0) {
-		for (int i=0; i<bucketcount; ++i) {array[i] = nullptr; bucket_sizes[i] = 0;}
+	//  Se reservan los segmentos necesarios: todos los buckets apuntan a nullptr y tamaños en 0
+	LinearHash(int M0=4): M0(M0), bucketcount(M0), p(0), i(0), datacount(0), capacity(0) {
+		grow_to(M0 - 1);
 	}
+	LinearHash(const LinearHash&) = delete;
+	LinearHash& operator=(const LinearHash&) = delete;
 private:
 
-	// Devuelve el índice de bucket donde debe ir una clave "key"
+	// Hash completo de la clave: se calcula una vez por operación y se guarda en el nodo
+	template<typename K>
+	size_t hash_of(const K& key) {return hasher(key);}
+
+
+	// Devuelve el índice de bucket donde debe ir un hash "base_hash"
 	// Aplica la lógica de:
-	//  - hash base
 	//  - módulo con M0 * 2^i
 	//  - si el índice cae en un bucket ya dividido (currindex < p), se usa la versión extendida (M0 * 2^(i+1))
-	size_t hash_index(TK key) {
-		std::hash<TK> ptr_hash;
-		size_t base_hash = ptr_hash(key);
-		size_t currindex = base_hash % ((1<<i)*M0);
-		size_t extindex = base_hash % ((1<<(i+1))*M0);
-		if (currindex < p) return extindex; return currindex;
-	}
-	// Versión siempre extendida del hash (para usar en split)
-	size_t extended_hash_index(TK key) {
-		std::hash<TK> ptr_hash;
-		size_t base_hash = ptr_hash(key);
-		return base_hash % ((1<<(i+1))*M0);
+	size_t hash_index(size_t base_hash) {
+		size_t L = size_t(M0) << i;
+		// Con M0 potencia de 2 (lo normal) el módulo es un AND; la rama siempre va para el mismo lado
+		if ((L & (L - 1)) == 0) {
+			size_t currindex = base_hash & (L - 1);
+			return currindex < size_t(p) ? base_hash & (2 * L - 1) : currindex;
+		}
+		size_t currindex = base_hash % L;
+		if (currindex < size_t(p)) return base_hash % (2 * L);
+		return currindex;
+	}
+	// En split: un nodo del bucket p (hash % L == p, con L = M0 * 2^i) pasa al bucket p + L
+	// si y solo si el bit "L" de hash / L es 1. Con M0 potencia de 2 es un AND directo.
+	bool moves_on_split(size_t base_hash, size_t L) {
+		if ((L & (L - 1)) == 0) return (base_hash & L) != 0;
+		return ((base_hash / L) & 1) != 0;
 	}
 public:
-	int visited_buckets() {return visited;}
+	// Hash de una clave fija: si cambia, los hashes guardados en un snapshot no sirven
+	// (ShardedLinearHash también lo usa para saber si los shards de un snapshot le sirven tal cual)
+	uint64_t hash_fingerprint() {
+		if constexpr (std::is_constructible_v<TK, const char*>) return uint64_t(hasher(TK("linearhash-snapshot")));
+		else if constexpr (std::is_default_constructible_v<TK>) return uint64_t(hasher(TK{}));
+		else return 0;
+	}
+
+	// Nodos visitados por todas las operaciones (0 con LinearHashNoStats)
+	uint64_t visited_buckets() {return stats.snapshot().total_probes();}
+
+	// Contadores de la política Stats más la distribución actual de largos de cadena
+	LinearHashStatsSnapshot stats_snapshot() {
+		LinearHashStatsSnapshot result = stats.snapshot();
+		if constexpr (Stats::enabled) {
+			for (int b = 0; b < bucketcount; ++b) ++result.chain_histogram[linearhash_length_bin(uint64_t(bsize(b)))];
+		}
+		return result;
+	}
 	int size() {return datacount;}
+
+	// Deja la tabla con buckets suficientes para n claves sin ningún split:
+	// bucketcount = ceil(n / maxFillFactor). Con la tabla vacía se salta directo al
+	// nivel i / puntero p de ese tamaño (sin recorrer nada); con datos se hacen los
+	// splits que falten, que solo redistribuyen nodos (el hash ya está guardado).
+	// No achica nunca.
+	void reserve(size_t n) {
+		size_t target = size_t(double(n) / maxFillFactor) + 1;
+		if (target <= size_t(bucketcount)) return;
+		grow_to(target - 1);
+		if (datacount > 0) {
+			while (size_t(bucketcount) < target) split();
+			return;
+		}
+		// L = M0 * 2^i más grande que no supera target; p = lo que falta
+		size_t L = size_t(M0);
+		int level = 0;
+		while (L * 2 <= target) {L *= 2; ++level;}
+		i = level;
+		p = int(target - L);
+		bucketcount = int(target);
+	}
+	// Limita la tabla a budget.max_entries entradas y/o budget.max_bytes bytes (0 = sin límite).
+	// Al pasarse, cada insert desaloja entradas frías con CLOCK (ver enforce_budget): try_get y
+	// multi_get marcan el bit de acceso del nodo y la aguja salva una vez a los marcados.
+	// evict(clave, valor) se llama justo antes de liberar cada entrada desalojada (no debe tocar
+	// la tabla). Si la tabla ya se pasa del presupuesto nuevo, se recorta en el acto.
+	// Los bytes son una estimación: sizeof del nodo + linearhash_extra_bytes de clave y valor
+	// (cambios hechos a través de los punteros que devuelven insert/try_emplace no se ven).
+	// Acota solo esta tabla: lo que el llamador guarde aparte por cada entrada (índices, colas
+	// de vencimiento, ...) no se cuenta; para que no quede huérfano, evict debe sacarlo.
+	void set_budget(LinearHashBudget limits, std::function<void(const TK&, const TV&)> evict = {}) {
+		budget = limits;
+		on_evict = std::move(evict);
+		budgeted = budget.max_entries != 0 || budget.max_bytes != 0;
+		if (budgeted) rebudget();
+		else bytes_used = 0;
+	}
+	// Entradas desalojadas por el presupuesto desde que se creó la tabla
+	uint64_t evicted_count() {return evicted;}
+	// Bytes estimados de las entradas (0 si no hay presupuesto)
+	size_t memory_bytes() {return bytes_used;}
+
 	int bucket_count() {return bucketcount;}
 	int bucket_size(int index) {
 		if(index < 0 || index >= bucketcount) throw std::runtime_error("Invalid bucket index");
-		return bucket_sizes[index];
-	}
-	void insert(TK key, TV value) {
-		// 1. Calcular el índice físico donde debería caer la clave
-		size_t index = hash_index(key);
-		// 2. Buscar si la clave ya existe en la lista del bucket
-		Node* current = array[index];
-		while(current != nullptr){
-			++visited;
-			// Si existe, solo actualizamos el valor y salimos
-			if(current->key == key) {current->value = value; return;}
-			current = current->next;
-		}
+		return bsize(index);
+	}
+	// Inserta o actualiza (mismo comportamiento de siempre); ver insert_or_assign
+	template<typename K, typename V>
+	void insert(K&& key, V&& value) {insert_or_assign(std::forward<K>(key), std::forward<V>(value));}
+
+	// Las tres variantes devuelven {puntero al valor guardado, true si se insertó un nodo nuevo}.
+	// El puntero sigue siendo válido tras splits/merges hasta que se borre esa clave.
+
+	// Si la clave no existe, construye el valor en el nodo con args...;
+	// si ya existe no toca nada (args no se consumen)
+	template<typename K, typename... Args>
+	std::pair<TV*, bool> try_emplace(K&& key, Args&&... args) {
+		// 1. Calcular el hash (una sola vez) y el índice físico donde debería caer la clave
+		size_t h = hash_of(key);
+		size_t index = hash_index(h);
+		// 2. Buscar si la clave ya existe en la lista del bucket (primero se compara el hash)
+		if (Node* found = find_node(index, h, key, LinearHashOp::insert)) return {&found->value, false};
 		// 3. Si la clave no existe, creamos un nuevo nodo y lo insertamos al inicio de la lista
-		Node* newNode = new Node(key, value);
-		newNode->next = array[index];
-		++visited;	// visitamos la posición de inserción
-		array[index] = newNode;
-		// Actualizar contadores globales
-		datacount++;
-		bucket_sizes[index]++;
-		// 4. Si el factor de carga supera el máximo permitido, se hace un split
-		if (fillFactor() > maxFillFactor) split();
+		Node* newNode = alloc.create(h, std::forward<K>(key), std::forward<Args>(args)...);
+		link_front(index, newNode);
+		return {&newNode->value, true};
 	}
 
+	// Si la clave existe, le asigna value; si no, crea el nodo con value
+	template<typename K, typename V>
+	std::pair<TV*, bool> insert_or_assign(K&& key, V&& value) {
+		return insert_or_assign_hashed(hash_of(key), std::forward<K>(key), std::forward<V>(value));
+	}
+private:
+	// insert_or_assign con el hash ya calculado (lo usan también las operaciones por lotes)
+	template<typename K, typename V>
+	std::pair<TV*, bool> insert_or_assign_hashed(size_t h, K&& key, V&& value) {
+		size_t index = hash_index(h);
+		// Si existe, solo actualizamos el valor y salimos
+		if (Node* found = find_node(index, h, key, LinearHashOp::insert)) {
+			if (!budgeted) {
+				found->value = std::forward<V>(value);
+				return {&found->value, false};
+			}
+			bytes_used -= node_bytes(found);
+			found->value = std::forward<V>(value);
+			bytes_used += node_bytes(found);
+			found->referenced = true;
+			enforce_budget(found);
+			return {&found->value, false};
+		}
+		Node* newNode = alloc.create(h, std::forward<K>(key), std::forward<V>(value));
+		link_front(index, newNode);
+		return {&newNode->value, true};
+	}
+public:
 
-	TV operator[](TK key) {
-		size_t index = hash_index(key);
-		Node* current = array[index];
-		while (current != nullptr) {
-			++visited;
-			if (current->key == key) {return current->value;}
-			current = current->next;
+	// Como en std::unordered_map: el nodo se construye primero con (key, args...)
+	// y se descarta si la clave ya existía
+	template<typename K, typename... Args>
+	std::pair<TV*, bool> emplace(K&& key, Args&&... args) {
+		Node* newNode = alloc.create(size_t(0), std::forward<K>(key), std::forward<Args>(args)...);
+		newNode->hash = hash_of(newNode->key);
+		size_t index = hash_index(newNode->hash);
+		if (Node* found = find_node(index, newNode->hash, newNode->key, LinearHashOp::insert)) {
+			alloc.destroy(newNode);
+			return {&found->value, false};
 		}
+		link_front(index, newNode);
+		return {&newNode->value, true};
+	}
+
+
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	TV operator[](const K& key) {
+		size_t h = hash_of(key);
+		if (Node* found = find_node(hash_index(h), h, key, LinearHashOp::get)) return found->value;
 		throw std::runtime_error("Key not found in linear hashing");
 	}
 
+	// Las búsquedas (operator[], remove, contains, try_get) aceptan cualquier K compatible
+	// (ver LinearHashLookupKey): con TK = std::string se puede pasar un std::string_view
+	// apuntando al buffer del request sin crear un std::string.
+
 	// Devuelve true si se eliminó algo, false si la clave no existía
-	bool remove(TK key) {
-		size_t index = hash_index(key);
-		Node* current = array[index];
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	bool remove(const K& key) {return remove_hashed(hash_of(key), key, [](const TV&) {return true;});}
+
+	// Como remove, pero borra solo si pred(valor) da true (p. ej. "la sesión sigue vencida").
+	// Devuelve false si la clave no existía o si pred dijo que no.
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K, typename Pred>
+	bool remove_if(const K& key, Pred&& pred) {return remove_hashed(hash_of(key), key, pred);}
+private:
+	template<typename K, typename Pred>
+	bool remove_hashed(size_t h, const K& key, Pred&& pred) {
+		size_t index = hash_index(h);
+		Node* current = head(index);
 		// Caso 1: bucket vacío
-		if (current == nullptr) return false;
-		++visited;
+		if (current == nullptr) {stats.record_probe(LinearHashOp::remove, 0); return false;}
+		uint64_t steps = 1;
 		// Caso 2: el primer nodo contiene la clave
-		if (current->key == key) {
-			auto temp = array[index];
-			array[index] = array[index]->next;
-			delete temp; temp = nullptr; --datacount; --bucket_sizes[index];
+		if (current->hash == h && key_equal(current->key, key)) {
+			stats.record_probe(LinearHashOp::remove, steps);
+			if (!pred(std::as_const(current->value))) return false;
+			auto temp = head(index);
+			head(index) = head(index)->next;
+			if (head(index) == nullptr) tail(index) = nullptr;
+			if (budgeted) bytes_used -= node_bytes(temp);
+			alloc.destroy(temp); temp = nullptr; --datacount; --bsize(index);
 			// Si el factor de carga está por debajo del límite inferior y la capacidad física es mayor que M0, hacemos merge
-			if (fillFactor() < lowerBound && capacity > M0) merge(); return true;
+			if (fillFactor() < lowerBound && bucketcount > M0) merge(); return true;
 		}
 
 		// Caso 3: la clave está en algún nodo intermedio o al final
 		while(current->next != nullptr){
-			++visited;
-			if (current->next->key == key) {
+			++steps;
+			if (current->next->hash == h && key_equal(current->next->key, key)) {
+				stats.record_probe(LinearHashOp::remove, steps);
+				if (!pred(std::as_const(current->next->value))) return false;
 				auto temp = current->next;
 				current->next = current->next->next;
-				delete temp; temp = nullptr; --datacount; --bucket_sizes[index];
-				if (fillFactor() < lowerBound && capacity > M0) merge(); return true;
+				if (temp == tail(index)) tail(index) = current;
+				if (budgeted) bytes_used -= node_bytes(temp);
+				alloc.destroy(temp); temp = nullptr; --datacount; --bsize(index);
+				if (fillFactor() < lowerBound && bucketcount > M0) merge(); return true;
 			}
 			current = current->next;
 		}
+		stats.record_probe(LinearHashOp::remove, steps);
 		return false;
 	}
+public:
 
 	// trivial
-	bool contains(TK key) {
-		size_t index = hash_index(key);
-		Node* current = array[index];
-		while(current != nullptr){
-			++visited;
-			if(current->key == key) return true;
-			current = current->next;
-		} return false;
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	bool contains(const K& key) {
+		size_t h = hash_of(key);
+		return find_node(hash_index(h), h, key, LinearHashOp::get) != nullptr;
 	}
 
 	// Borra todos los nodos de todos los buckets y resetea contadores
 	void clear() {
 		for (int b = 0; b < bucketcount; ++b) {
-			Node* curr = array[b];
+			Node* curr = head(b);
 			while (curr != nullptr) {
 				Node* temp = curr;
 				curr = curr->next;
-				delete temp;
+				alloc.dispose(temp);
 			}
-			array[b] = nullptr;
-			bucket_sizes[b] = 0;
+			head(b) = nullptr;
+			tail(b) = nullptr;
+			bsize(b) = 0;
 		}
+		// Liberación en bloque de la memoria de nodos (pool: se devuelven los slabs)
+		alloc.reset();
 		datacount = 0;
-		visited = 0;
+		bytes_used = 0;
+		hand = 0;
 		// Nota: p, i, bucketcount, capacity se mantienen
 	}
 
 	// Devuelve true si encuentra la clave, false si no. En caso de éxito, out_value se llena con el valor correspondiente (struct Sesion)
-	bool try_get(TK key, TV &out_value) {
-		size_t index = hash_index(key);
-		Node* current = array[index];
-		while (current != nullptr) {
-			++visited;
-			if (current->key == key) {
-				out_value = current->value;
-				return true;
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	bool try_get(const K& key, TV &out_value) {
+		size_t h = hash_of(key);
+		Node* found = find_node(hash_index(h), h, key, LinearHashOp::get);
+		if (found == nullptr) return false;
+		mark_referenced(found);
+		out_value = found->value;
+		return true;
+	}
+
+	// Puntero al valor de key o nullptr si no existe; válido hasta que se borre esa clave
+	// (igual que try_emplace). Si se cambia el valor en el lugar y hay presupuesto en bytes,
+	// el cambio de tamaño no se contabiliza.
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	TV* find(const K& key) {
+		size_t h = hash_of(key);
+		Node* found = find_node(hash_index(h), h, key, LinearHashOp::get);
+		if (found == nullptr) return nullptr;
+		mark_referenced(found);
+		return &found->value;
+	}
+
+	// Operaciones por lotes (validar ráfagas de tokens): en lugar de resolver una clave
+	// por vez y esperar cada fallo de caché, cada grupo de claves se procesa en etapas:
+	//  1. se calculan todos los hashes y se pide a caché la cabeza de cada bucket,
+	//  2. se pide a caché el primer nodo de cada bucket,
+	//  3. recién entonces se resuelven las búsquedas; los accesos ya están en vuelo en paralelo.
+	// Keys puede ser cualquier rango de acceso aleatorio (std::span, std::vector, ...) de claves
+	// aceptadas por las búsquedas (std::string o std::string_view si TK = std::string).
+
+	// out[j] = puntero al valor de keys[j] o nullptr si no existe. Devuelve cuántas se encontraron.
+	// Los punteros son válidos hasta que se borre esa clave (igual que try_emplace).
+	template<std::ranges::random_access_range Keys>
+	requires LinearHashLookupKey<std::ranges::range_value_t<Keys>, TK, Hash, KeyEqual>
+	size_t multi_get(const Keys& keys, std::span<TV*> out) {
+		if (out.size() < std::ranges::size(keys)) throw std::invalid_argument("multi_get: out is smaller than keys");
+		size_t encontrados = 0;
+		for_each_batched(keys, [&](size_t j, size_t h) {
+			Node* found = find_node(hash_index(h), h, keys[j], LinearHashOp::get);
+			if (found != nullptr) mark_referenced(found);
+			out[j] = found != nullptr ? &found->value : nullptr;
+			encontrados += found != nullptr;
+		});
+		return encontrados;
+	}
+
+	// items: rango de pares (clave, valor); cada uno se inserta o actualiza como insert().
+	// Devuelve cuántas claves eran nuevas.
+	template<std::ranges::random_access_range Items>
+	size_t multi_insert(const Items& items) {
+		size_t nuevos = 0;
+		auto keys = items | std::views::transform([](const auto& item) -> const auto& {return item.first;});
+		for_each_batched(keys, [&](size_t j, size_t h) {
+			const auto& item = items[j];
+			nuevos += insert_or_assign_hashed(h, item.first, item.second).second;
+		});
+		return nuevos;
+	}
+
+	// Devuelve cuántas claves se borraron
+	template<std::ranges::random_access_range Keys>
+	requires LinearHashLookupKey<std::ranges::range_value_t<Keys>, TK, Hash, KeyEqual>
+	size_t multi_remove(const Keys& keys) {
+		size_t eliminados = 0;
+		auto always = [](const TV&) {return true;};
+		for_each_batched(keys, [&](size_t j, size_t h) {eliminados += remove_hashed(h, keys[j], always);});
+		return eliminados;
+	}
+
+	// Carga masiva de pares (clave, valor) (CSV, sesiones restauradas): equivale a
+	// insert() de cada elemento en orden (si una clave se repite gana la última),
+	// pero sin un split por elemento y repartiendo el trabajo entre "threads" hilos:
+	//  1. reserve(): la tabla queda con su tamaño final de una vez.
+	//  2. En paralelo por tramos de la entrada: hash de cada clave y conteo por partición
+	//     (cada partición es un rango contiguo de buckets).
+	//  3. Se reparten las posiciones de la entrada por partición (conservando el orden).
+	//  4. En paralelo por partición: cada hilo crea los nodos y arma las cadenas de sus
+	//     buckets; ningún otro hilo toca esos buckets, así que no hace falta ningún lock.
+	// Si el allocator no admite create() concurrente (pool), se usa un solo hilo.
+	// No es thread-safe respecto de otras operaciones sobre la tabla (igual que insert).
+	template<std::ranges::random_access_range Items>
+	void bulk_build(const Items& items, unsigned threads = std::thread::hardware_concurrency()) {
+		size_t n = std::ranges::size(items);
+		if (n == 0) return;
+		if (!NodeAlloc<Node>::concurrent_create || threads == 0) threads = 1;
+		threads = unsigned(std::min<size_t>(threads, (n + 4095) / 4096));
+		reserve(size_t(datacount) + n);
+
+		size_t parts = size_t(threads) * 4;
+		size_t buckets = size_t(bucketcount);
+		auto part_of = [&](size_t index) {return index * parts / buckets;};
+		std::vector<size_t> hashes(n);
+		std::vector<size_t> order(n);
+		// counts[t * parts + q]: elementos del tramo t que caen en la partición q
+		std::vector<size_t> counts(size_t(threads) * parts, 0);
+		auto slice = [&](unsigned t) {return std::pair<size_t, size_t>(n * t / threads, n * (t + 1) / threads);};
+		auto in_parallel = [&](auto&& work) {run_parallel(threads, work);};
+
+		in_parallel([&](unsigned t) {
+			auto [from, to] = slice(t);
+			for (size_t k = from; k < to; ++k) {
+				hashes[k] = hash_of(items[k].first);
+				++counts[t * parts + part_of(hash_index(hashes[k]))];
 			}
-			current = current->next;
+		});
+		// Prefijos: la partición q ocupa [start[q], start[q + 1]) de "order",
+		// y dentro de ella el tramo t escribe después de los tramos anteriores
+		std::vector<size_t> start(parts + 1, 0);
+		for (size_t q = 0; q < parts; ++q) {
+			size_t offset = start[q];
+			for (unsigned t = 0; t < threads; ++t) {
+				size_t c = counts[t * parts + q];
+				counts[t * parts + q] = offset;
+				offset += c;
+			}
+			start[q + 1] = offset;
 		}
-		return false;
+		in_parallel([&](unsigned t) {
+			auto [from, to] = slice(t);
+			for (size_t k = from; k < to; ++k) order[counts[t * parts + part_of(hash_index(hashes[k]))]++] = k;
+		});
+
+		std::atomic<size_t> next_part(0);
+		std::atomic<int> added(0);
+		in_parallel([&](unsigned) {
+			int local = 0;
+			for (size_t q = next_part++; q < parts; q = next_part++) {
+				for (size_t pos = start[q]; pos < start[q + 1]; ++pos) {
+					size_t k = order[pos];
+					size_t h = hashes[k];
+					size_t index = hash_index(h);
+					Node* current = head(index);
+					while (current != nullptr && !(current->hash == h && key_equal(current->key, items[k].first))) current = current->next;
+					if (current != nullptr) {current->value = items[k].second; continue;}
+					Node* newNode = alloc.create(h, items[k].first, items[k].second);
+					newNode->next = head(index);
+					if (head(index) == nullptr) tail(index) = newNode;
+					head(index) = newNode;
+					++bsize(index);
+					++local;
+				}
+			}
+			added += local;
+		});
+		datacount += added.load();
+		if (budgeted) rebudget();
+	}
+
+	// Snapshot binario (formato en linearhash_snapshot.h). KeySer / ValueSer: serializadores
+	// de clave y valor (por defecto LinearHashSerializer<TK> / LinearHashSerializer<TV>).
+	template<typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+	void write_snapshot(std::ostream& out) {
+		std::vector<uint64_t> offsets(size_t(bucketcount) + 1);
+		std::string body;
+		for (int b = 0; b < bucketcount; ++b) {
+			offsets[b] = body.size();
+			for (Node* curr = head(b); curr != nullptr; curr = curr->next) {
+				LinearHashSerializer<uint64_t>::write(body, uint64_t(curr->hash));
+				KeySer::write(body, curr->key);
+				ValueSer::write(body, curr->value);
+			}
+		}
+		offsets[bucketcount] = body.size();
+		LinearHashSnapshotHeader header;
+		std::memcpy(header.magic, linearhash_snapshot_magic, sizeof(header.magic));
+		header.byte_order = linearhash_snapshot_byte_order;
+		header.size_t_bytes = uint32_t(sizeof(size_t));
+		header.hash_fingerprint = hash_fingerprint();
+		header.M0 = uint64_t(M0); header.i = uint64_t(i); header.p = uint64_t(p);
+		header.bucketcount = uint64_t(bucketcount); header.datacount = uint64_t(datacount);
+		header.body_bytes = body.size();
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(offsets.data()), std::streamsize(offsets.size() * sizeof(uint64_t)));
+		out.write(body.data(), std::streamsize(body.size()));
+		if (!out) throw std::runtime_error("LinearHash snapshot: write failed");
+	}
+
+	// Escribe en path + ".tmp" y después renombra: un corte a mitad de camino no deja
+	// un snapshot roto en "path"
+	template<typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+	void save_snapshot(const std::string& path) {
+		std::string tmp = path + ".tmp";
+		{
+			std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+			if (!out) throw std::runtime_error("LinearHash snapshot: cannot create " + tmp);
+			write_snapshot<KeySer, ValueSer>(out);
+		}
+		std::filesystem::rename(tmp, path);
+	}
+
+	// Reemplaza el contenido de la tabla con el snapshot en [data, data + size).
+	// Si el hasher coincide (hash_fingerprint), los buckets se arman directamente con el
+	// nivel i / puntero p / hashes guardados, repartiendo rangos de buckets entre "threads"
+	// hilos (si el allocator lo permite). Si no coincide, se inserta elemento por elemento.
+	template<typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+	void load_snapshot_from_memory(const char* data, size_t size, unsigned threads = std::thread::hardware_concurrency()) {
+		LinearHashSnapshotHeader header;
+		linearhash_snapshot_check(size >= sizeof(header), "file too small");
+		std::memcpy(&header, data, sizeof(header));
+		linearhash_snapshot_check(std::memcmp(header.magic, linearhash_snapshot_magic, sizeof(header.magic)) == 0, "bad magic");
+		linearhash_snapshot_check(header.byte_order == linearhash_snapshot_byte_order, "byte order mismatch");
+		linearhash_snapshot_check(header.M0 > 0 && header.M0 <= uint64_t(INT32_MAX) && header.i < 32 &&
+								  header.bucketcount >= header.M0 && header.p < (header.M0 << header.i) &&
+								  header.bucketcount == (header.M0 << header.i) + header.p, "inconsistent i/p/bucketcount");
+		size_t offsets_bytes = size_t(header.bucketcount + 1) * sizeof(uint64_t);
+		linearhash_snapshot_check(size - sizeof(header) >= offsets_bytes &&
+								  size - sizeof(header) - offsets_bytes >= header.body_bytes, "truncated file");
+		const char* offsets = data + sizeof(header);
+		const char* body = offsets + offsets_bytes;
+		auto offset = [&](size_t b) {
+			uint64_t value;
+			std::memcpy(&value, offsets + b * sizeof(uint64_t), sizeof(value));
+			linearhash_snapshot_check(value <= header.body_bytes, "bad bucket offset");
+			return value;
+		};
+		// Lee un registro: devuelve dónde sigue
+		auto read_entry = [&](const char* in, const char* end, uint64_t& h, TK& key, TV& value) {
+			in = LinearHashSerializer<uint64_t>::read(in, end, h);
+			in = KeySer::read(in, end, key);
+			return ValueSer::read(in, end, value);
+		};
+
+		clear();
+		if (header.hash_fingerprint != hash_fingerprint() || header.size_t_bytes != sizeof(size_t)) {
+			// Otro hasher (otra plataforma / otra biblioteca estándar): hay que rehashear
+			const char* in = body;
+			const char* end = body + header.body_bytes;
+			while (in < end) {
+				uint64_t h; TK key; TV value;
+				in = read_entry(in, end, h, key, value);
+				insert_or_assign(std::move(key), std::move(value));
+			}
+			return;
+		}
+
+		M0 = int(header.M0); i = int(header.i); p = int(header.p);
+		bucketcount = int(header.bucketcount);
+		grow_to(size_t(bucketcount) - 1);
+		shrink_segments();
+		if (!NodeAlloc<Node>::concurrent_create || threads == 0) threads = 1;
+		threads = unsigned(std::min<size_t>(threads, size_t(bucketcount)));
+		// Rangos de buckets con cantidades de bytes parecidas
+		std::vector<size_t> cuts(threads + 1, size_t(bucketcount));
+		cuts[0] = 0;
+		for (size_t b = 0, t = 1; b < size_t(bucketcount) && t < threads; ++b) {
+			if (offset(b) * threads >= header.body_bytes * t) cuts[t++] = b;
+		}
+		std::atomic<int> loaded(0);
+		std::mutex error_mutex;
+		std::exception_ptr error;
+		auto work = [&](unsigned t) {
+			int local = 0;
+			try {
+				for (size_t b = cuts[t]; b < cuts[t + 1]; ++b) {
+					const char* in = body + offset(b);
+					const char* end = body + offset(b + 1);
+					linearhash_snapshot_check(in <= end, "bad bucket offset");
+					Node* last = nullptr;
+					while (in < end) {
+						uint64_t h; TK key; TV value;
+						in = read_entry(in, end, h, key, value);
+						linearhash_snapshot_check(hash_index(size_t(h)) == b, "entry in wrong bucket");
+						Node* node = alloc.create(size_t(h), std::move(key), std::move(value));
+						// Se agrega al final: el orden de la cadena queda igual que al guardar
+						if (last == nullptr) head(b) = node;
+						else last->next = node;
+						last = node;
+						++bsize(b);
+						++local;
+					}
+					tail(b) = last;
+				}
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if (!error) error = std::current_exception();
+			}
+			loaded += local;
+		};
+		run_parallel(threads, work);
+		datacount = loaded.load();
+		if (!error && uint64_t(datacount) != header.datacount)
+			error = std::make_exception_ptr(std::runtime_error("LinearHash snapshot: entry count mismatch"));
+		// Snapshot corrupto: no queda nada a medio cargar
+		if (error) {clear(); std::rethrow_exception(error);}
+		if (budgeted) rebudget();
+	}
+
+	// Carga desde un archivo mapeado en memoria (ver load_snapshot_from_memory)
+	template<typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+	void load_snapshot(const std::string& path, unsigned threads = std::thread::hardware_concurrency()) {
+		LinearHashMappedFile file(path);
+		load_snapshot_from_memory<KeySer, ValueSer>(file.data(), file.size(), threads);
 	}
 
 	// Log tras cada interacción con LinearHashing
@@ -218,9 +778,13 @@ public:
 			 << "  datacount=" << datacount
 			 << "  fillFactor=" << fillFactor()
 			 << "\n";
+		if (budgeted) {
+			cout << "presupuesto: entradas=" << budget.max_entries << " bytes=" << budget.max_bytes
+				 << "  usados=" << bytes_used << "  desalojadas=" << evicted << "\n";
+		}
 		for (int b = 0; b < bucketcount; ++b) {
-			cout << "Bucket " << b << " (size=" << bucket_sizes[b] << "): ";
-			Node* curr = array[b];
+			cout << "Bucket " << b << " (size=" << bsize(b) << "): ";
+			Node* curr = head(b);
 			if (!curr) {
 				cout << "[vacio]";
 			} else {
@@ -238,82 +802,195 @@ public:
 	// Recorre todos los elementos de la tabla y aplica una función callback
 	// La función callback recibe: (TK key, TV& value) -> bool
 	// Si retorna true, el elemento se elimina; si retorna false, se mantiene
+	// Una sola pasada: los nodos se desenlazan y liberan en el mismo recorrido (no se copia
+	// ninguna clave ni se vuelve a hashear). Durante el recorrido no se hace merge; los que
+	// hagan falta se aplican todos juntos al final (cada merge es O(1)).
 	template<typename Func>
-	int for_each_remove_if(Func callback) {
-		int eliminados = 0;
-		std::vector<TK> tokens_a_eliminar;
-		
-		// Primera pasada: identificar tokens a eliminar
+	LinearHashSweepResult for_each_remove_if(Func callback) {
+		LinearHashSweepResult result;
 		for (int b = 0; b < bucketcount; ++b) {
-			Node* curr = array[b];
+			Node* prev = nullptr;
+			Node* curr = head(b);
 			while (curr != nullptr) {
-				++visited;
+				Node* next = curr->next;
 				if (callback(curr->key, curr->value)) {
-					tokens_a_eliminar.push_back(curr->key);
-				}
-				curr = curr->next;
+					if (prev != nullptr) prev->next = next;
+					else head(b) = next;
+					if (budgeted) bytes_used -= node_bytes(curr);
+					alloc.destroy(curr);
+					--bsize(b); --datacount; ++result.removed;
+				} else prev = curr;
+				curr = next;
 			}
+			// El último nodo que quedó es la nueva cola
+			tail(b) = prev;
 		}
-		
-		// Segunda pasada: eliminar los tokens identificados
-		for (const TK& token : tokens_a_eliminar) {
-			if (remove(token)) {
-				++eliminados;
-			}
+		while (fillFactor() < lowerBound && bucketcount > M0) {
+			merge();
+			++result.merges;
 		}
-		
-		return eliminados;
+		return result;
 	}
 
 private:
-	// Se llama cuando el factor de carga supera maxFillFactor.
-	// Puede duplicar la capacidad física del array
-	// Reubica elementos del bucket p hacia el nuevo bucket según el hash extendido.
-	void split() {
-		// Si p == 0 significa que vamos a pasar a un nuevo "ciclo" de splits
-		// y necesitamos duplicar la capacidad física
-		if (p == 0) {
-			// Crear nuevos arreglos con la nueva capacidad
-			auto oldcapacity = capacity; capacity *= 2;
-			Node** new_array = new Node*[capacity]();
-			int* new_bucket_sizes = new int[capacity]();
-			// Copiar el contenido de los buckets existentes
-			for (int i=0; i<oldcapacity; ++i) {
-				new_bucket_sizes[i] = bucket_sizes[i];
-				new_array[i] = array[i];
+	// Ejecuta work(t) para t = 0..threads-1, cada uno en su hilo (el 0 en el hilo actual)
+	template<typename Work>
+	static void run_parallel(unsigned threads, Work& work) {
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < threads; ++t) workers.emplace_back([&work, t] {work(t);});
+		work(0u);
+		for (auto& worker : workers) worker.join();
+	}
+
+	// Claves por grupo en las operaciones por lotes: suficientes para solapar los fallos
+	// de caché sin que los prefetch de un grupo expulsen los del anterior
+	static constexpr size_t batch_group = 16;
+
+	// Etapas 1 y 2 de las operaciones por lotes; fn(j, hash) resuelve la clave j.
+	// fn puede hacer split/merge: por eso el índice se recalcula ahí (el prefetch es solo una pista).
+	template<typename Keys, typename Fn>
+	void for_each_batched(const Keys& keys, Fn fn) {
+		size_t n = std::ranges::size(keys);
+		size_t hashes[batch_group];
+		for (size_t base = 0; base < n; base += batch_group) {
+			size_t count = std::min(batch_group, n - base);
+			for (size_t j = 0; j < count; ++j) {
+				hashes[j] = hash_of(keys[base + j]);
+				linearhash_prefetch(&head(hash_index(hashes[j])));
 			}
-			// Inicializar la nueva mitad
-			for (int i=oldcapacity; i<capacity; ++i) {
-				new_bucket_sizes[i] = 0; new_array[i] = nullptr;
+			for (size_t j = 0; j < count; ++j) {
+				if (Node* first = head(hash_index(hashes[j]))) linearhash_prefetch(first);
 			}
-			// Liberar los arreglos antiguos
-			delete[] array; delete[] bucket_sizes;
-			array = new_array; bucket_sizes = new_bucket_sizes;
+			for (size_t j = 0; j < count; ++j) fn(base + j, hashes[j]);
 		}
+	}
+
+	// Recorre el bucket "index" buscando la clave (primero compara el hash guardado).
+	// Registra en stats los nodos mirados por la operación "op".
+	template<typename K>
+	Node* find_node(size_t index, size_t h, const K& key, LinearHashOp op) {
+		uint64_t steps = 0;
+		Node* current = head(index);
+		while (current != nullptr) {
+			++steps;
+			if (current->hash == h && key_equal(current->key, key)) break;
+			current = current->next;
+		}
+		stats.record_probe(op, steps);
+		return current;
+	}
+
+	// Bit de acceso del CLOCK desde una búsqueda (se escribe solo si cambia: la línea ya está
+	// en caché). Atómico porque ShardedLinearHash deja buscar a varios lectores a la vez sin
+	// lock; el CLOCK (enforce_budget) corre siempre con los lectores excluidos.
+	static void mark_referenced(Node* node) {
+		std::atomic_ref<bool> referenced(node->referenced);
+		if (!referenced.load(std::memory_order_relaxed)) referenced.store(true, std::memory_order_relaxed);
+	}
+
+	// Enlaza un nodo nuevo al inicio del bucket "index", actualiza contadores
+	// y hace split si el factor de carga supera el máximo permitido
+	void link_front(size_t index, Node* newNode) {
+		newNode->next = head(index);
+		if (head(index) == nullptr) tail(index) = newNode;
+		head(index) = newNode;
+		// Actualizar contadores globales
+		datacount++;
+		bsize(index)++;
+		if (fillFactor() > maxFillFactor) split();
+		if (budgeted) {
+			// Una entrada recién creada arranca "caliente": no se desaloja en esta misma vuelta
+			bytes_used += node_bytes(newNode);
+			newNode->referenced = true;
+			enforce_budget(newNode);
+		}
+	}
+
+	size_t node_bytes(const Node* node) {
+		return sizeof(Node) + linearhash_extra_bytes(node->key) + linearhash_extra_bytes(node->value);
+	}
+	bool over_budget() {
+		return (budget.max_entries != 0 && size_t(datacount) > budget.max_entries) ||
+			(budget.max_bytes != 0 && bytes_used > budget.max_bytes);
+	}
+	// Recalcula los bytes recorriendo todo (al fijar el presupuesto o después de una carga masiva)
+	void rebudget() {
+		bytes_used = 0;
+		for (int b = 0; b < bucketcount; ++b) {
+			for (Node* curr = head(b); curr != nullptr; curr = curr->next) bytes_used += node_bytes(curr);
+		}
+		enforce_budget(nullptr);
+	}
+
+	// CLOCK: mientras la tabla se pase del presupuesto, la aguja recorre los buckets en orden;
+	// un nodo con el bit de acceso prendido se salva esta vuelta (se le apaga el bit), uno con
+	// el bit apagado no se usó desde la vuelta anterior y se desaloja (avisando a on_evict).
+	// Cada nodo mirado se desaloja o paga el bit que puso un acceso anterior: O(1) amortizado
+	// por operación. "keep" (el nodo que se está insertando) no se toca. Los merges que hagan
+	// falta se hacen al final, juntos.
+	void enforce_budget(Node* keep) {
+		if (!over_budget()) return;
+		while (over_budget() && datacount > (keep != nullptr ? 1 : 0)) {
+			if (hand >= size_t(bucketcount)) hand = 0;
+			Node* prev = nullptr;
+			Node* curr = head(hand);
+			while (curr != nullptr && over_budget()) {
+				Node* next = curr->next;
+				if (curr == keep || curr->referenced) {
+					if (curr != keep) curr->referenced = false;
+					prev = curr;
+				} else {
+					if (prev != nullptr) prev->next = next;
+					else head(hand) = next;
+					if (on_evict) on_evict(curr->key, curr->value);
+					bytes_used -= node_bytes(curr);
+					alloc.destroy(curr);
+					--bsize(hand); --datacount; ++evicted;
+				}
+				curr = next;
+			}
+			// Bucket terminado: prev es la nueva cola y la aguja pasa al siguiente
+			if (curr == nullptr) {
+				tail(hand) = prev;
+				++hand;
+			}
+		}
+		while (fillFactor() < lowerBound && bucketcount > M0) merge();
+	}
+
+	// Se llama cuando el factor de carga supera maxFillFactor.
+	// Reubica elementos del bucket p hacia el nuevo bucket según el hash extendido.
+	// Ya no hay duplicación del array: si el nuevo bucket no entra, se agrega un segmento.
+	void split() {
+		auto timer = stats.timer();
+		// El nuevo bucket es p + M0 * 2^i (siempre el siguiente bucket lógico, y está vacío)
+		size_t L = size_t(M0) << i;
+		size_t newindex = p + L;
+		grow_to(newindex);
 		// Aumentamos la cantidad de buckets lógicos (uno más se activa)
 		++bucketcount;
-		// Reubicamos nodos del bucket p usando el hash extendido
-		Node* currnode = array[p];
+		// Reubicamos nodos del bucket p usando el hash guardado en cada nodo (sin rehashear la clave)
+		Node* currnode = head(p);
 		Node* prevnode = nullptr;
 		while (currnode != nullptr) {
-			++visited;
 			Node* nextnode = currnode->next;
-			// Índice nuevo con la tabla extendida
-			size_t newindex = extended_hash_index(currnode->key);
-			if (newindex != p) {
+			if (moves_on_split(currnode->hash, L)) {
 				// El nodo debe moverse al nuevo bucket "newindex"
 				if (prevnode != nullptr) prevnode->next = nextnode;
-				else array[p] = nextnode;
+				else head(p) = nextnode;
 				// Insertar nodo movido al inicio del bucket newindex
-				currnode->next = array[newindex];
-				array[newindex] = currnode;
-				++bucket_sizes[newindex]; --bucket_sizes[p];
+				if (head(newindex) == nullptr) tail(newindex) = currnode;
+				currnode->next = head(newindex);
+				head(newindex) = currnode;
+				++bsize(newindex); --bsize(p);
 			} else {
 				// El nodo se queda en el bucket p
 				prevnode = currnode;
 			}
 			currnode = nextnode;
 		}
+		// El último nodo que se quedó es la nueva cola de p
+		tail(p) = prevnode;
 		// Avanzar el puntero de split
 		++p;
 		// Si ya hemos dividido todos los buckets del rango actual,
@@ -321,66 +998,154 @@ private:
 		if (p == (M0 * (1 << i))) {
 			++i; p = 0;
 		}
+		stats.record_split(timer);
 	}
 
 
 	// Se llama cuando el factor de carga baja de lowerBound
 	// Junta el último bucket con el bucket p-1 (en orden lógico inverso).
-	// Puede reducir la capacidad física a la mitad
+	// Puede liberar el último segmento del directorio
 	void merge() {
+		auto timer = stats.timer();
 		// Ajustamos p hacia atrás:
 		// Si p == 0, retrocedemos nivel (i--) y ponemos p al último bucket del nivel
 		// Si p > 0, simplemente decrementamos p.
 		if (p == 0) {
-			--i; p = M0 * (1 << i);
+			--i; p = M0 * (1 << i) - 1;
 		} else --p;
-		// Curr apunta al bucket p donde vamos a fusionar
-		auto curr = array[p];
+		int last = bucketcount - 1;
 		// Agregar al tamaño del bucket p los elementos del último bucket lógico
-		bucket_sizes[p] += bucket_sizes[bucketcount-1]; bucket_sizes[bucketcount-1] = 0;
-		// Si el bucket p estaba vacío, simplemente apuntamos al último bucket
-		if (curr == nullptr) array[p] = array[bucketcount-1];
-		else {
-			// Si no está vacío, vamos al final de la lista para "concatenar"
-			while (curr->next != nullptr) {++visited; curr = curr->next;}
-			curr->next = array[bucketcount-1];
+		bsize(p) += bsize(last); bsize(last) = 0;
+		// Concatenar en O(1) usando la cola de p (sin recorrer la lista)
+		if (head(last) != nullptr) {
+			if (head(p) == nullptr) head(p) = head(last);
+			else tail(p)->next = head(last);
+			tail(p) = tail(last);
 		}
 		// El último bucket lógico queda vacío
-		array[bucketcount-1] = nullptr;
+		head(last) = nullptr; tail(last) = nullptr;
 		// Disminuimos la cantidad de buckets lógicos
 		--bucketcount;
-		// Si p vuelve a ser 0, quiere decir que hemos "bajado" a un nivel anterior
-		// y podemos reducir la capacidad física a la mitad
-		if (p == 0) {
-			capacity /= 2;
-			Node** new_array = new Node*[capacity]();
-			int* new_bucket_sizes = new int[capacity]();
-			for (int i=0; i<capacity; ++i) {
-				new_bucket_sizes[i] = bucket_sizes[i];
-				new_array[i] = array[i];
-			}
-			delete[] array; delete[] bucket_sizes;
-			array = new_array; bucket_sizes = new_bucket_sizes;
-		}
+		// Si el último segmento quedó sin uso se libera (sin copiar nada)
+		shrink_segments();
+		stats.record_merge(timer);
 	}
 public:
 
-	Iterator begin(int index) {return Iterator(array[index]);}
+	Iterator begin(int index) {return Iterator(head(index));}
 	Iterator end(int index) {return Iterator(nullptr);}
 
-	// Libera toda la memoria de los nodos y de los arreglos.
+	// Iterador forward sobre toda la tabla (o un rango de buckets): recorre bucket por
+	// bucket y, dentro de cada uno, la cadena. Desreferenciar da un LinearHashEntry
+	// (entry.key constante, entry.value modificable) y no el nodo: así nadie puede cambiar
+	// la clave, el hash o el next de un nodo que ya está en la tabla. Sirve con
+	// for (auto entry : tabla), for (auto [key, value] : tabla) y con los algoritmos de
+	// <algorithm>. Cualquier insert/remove (split/merge) lo invalida.
+	class iterator {
+		LinearHash* table;
+		size_t bucket, last;   // bucket actual y fin (exclusivo) del rango
+		Node* node;            // nullptr = fin
+		// Avanza hasta el primer bucket no vacío del rango
+		void settle() {
+			while (node == nullptr && ++bucket < last) node = table->head(bucket);
+		}
+	public:
+		// Forward para los conceptos de C++20; para los iteradores "legacy" la referencia
+		// tiene que ser value_type&, y un proxy solo llega a input
+		using iterator_concept = std::forward_iterator_tag;
+		using iterator_category = std::input_iterator_tag;
+		using value_type = LinearHashEntry<TK, TV>;
+		using difference_type = std::ptrdiff_t;
+		using reference = LinearHashEntry<TK, TV>;
+		// it->key / it->value: el proxy vive dentro del objeto que devuelve operator->
+		struct pointer {
+			reference entry;
+			const reference* operator->() const {return &entry;}
+		};
+
+		iterator(): table(nullptr), bucket(0), last(0), node(nullptr) {}
+		iterator(LinearHash* table, size_t first, size_t last):
+			table(table), bucket(first), last(last), node(first < last ? table->head(first) : nullptr) {
+			if (node == nullptr) settle();
+		}
+		reference operator*() const {return reference{node->key, node->value};}
+		pointer operator->() const {return pointer{**this};}
+		iterator& operator++() {
+			node = node->next;
+			if (node == nullptr) settle();
+			return *this;
+		}
+		iterator operator++(int) {iterator copy = *this; ++*this; return copy;}
+		// Todos los finales son iguales (node == nullptr), sin importar el rango
+		bool operator==(const iterator& other) const {return node == other.node;}
+	};
+
+	// Buckets [first, last) como rango iterable (una porción de la tabla)
+	class BucketRange {
+		LinearHash* table;
+	public:
+		size_t first, last;
+		BucketRange(LinearHash* table, size_t first, size_t last): table(table), first(first), last(last) {}
+		iterator begin() const {return iterator(table, first, last);}
+		iterator end() const {return iterator();}
+	};
+
+	iterator begin() {return iterator(this, 0, size_t(bucketcount));}
+	iterator end() {return iterator();}
+
+	// Parte los buckets activos en a lo sumo "parts" rangos contiguos con cantidades de
+	// elementos parecidas (según el tamaño de cada bucket). Cada rango se puede recorrer
+	// en un hilo distinto mientras nadie modifique la tabla, por ejemplo:
+	//   auto partes = tabla.partition(hilos);
+	//   std::for_each(std::execution::par, partes.begin(), partes.end(),
+	//                 [](const auto& rango) {for (auto entry : rango) {...}});
+	std::vector<BucketRange> partition(size_t parts) {
+		std::vector<BucketRange> ranges;
+		size_t buckets = size_t(bucketcount);
+		parts = std::max<size_t>(1, std::min(parts, buckets));
+		size_t total = size_t(datacount);
+		size_t first = 0, acumulado = 0;
+		for (size_t b = 0; b < buckets; ++b) {
+			acumulado += size_t(bsize(b));
+			// Se corta cuando el acumulado llega a la fracción (k + 1) / parts del total
+			size_t k = ranges.size();
+			if (k + 1 < parts && acumulado * parts >= total * (k + 1) && total > 0) {
+				ranges.emplace_back(this, first, b + 1);
+				first = b + 1;
+			}
+		}
+		ranges.emplace_back(this, first, buckets);
+		return ranges;
+	}
+
+	// Aplica fn(key, value) a todos los elementos repartiendo partition() entre "threads" hilos.
+	// fn debe poder correr en paralelo consigo misma; la tabla no se puede modificar mientras tanto.
+	template<typename Func>
+	void parallel_for_each(Func fn, unsigned threads = std::thread::hardware_concurrency()) {
+		threads = std::max(1u, threads);
+		std::vector<BucketRange> ranges = partition(size_t(threads) * 4);
+		std::atomic<size_t> next_range(0);
+		auto work = [&](unsigned) {
+			for (size_t q = next_range++; q < ranges.size(); q = next_range++) {
+				for (auto entry : ranges[q]) fn(entry.key, entry.value);
+			}
+		};
+		run_parallel(unsigned(std::min<size_t>(threads, ranges.size())), work);
+	}
+
+	// Libera toda la memoria de los nodos y de los segmentos.
 	~LinearHash() {
 		// Borrar todos los nodos de todos los buckets físicos
 		for (int i=0; i<capacity; ++i) {
-			while (array[i] != nullptr) {
-				auto temp = array[i];
-				array[i] = array[i]->next;
-				delete temp;
+			while (head(i) != nullptr) {
+				auto temp = head(i);
+				head(i) = head(i)->next;
+				alloc.dispose(temp);
 			}
 		}
-		delete[] array;
-		array = nullptr;
-		delete[] bucket_sizes;
-		bucket_sizes = nullptr;
+		for (Segment* segment : segments) delete segment;
+		segments.clear();
 	}
-};
\ No newline at end of file
+};
+
+#endif //LINEARHASH_H
@@ -0,0 +1,121 @@
+#ifndef LINEARHASH_ALLOC_H
+#define LINEARHASH_ALLOC_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Políticas de asignación de nodos para LinearHash.
+// Cada política ofrece:
+//  - create(args...): construye un nodo nuevo
+//  - destroy(node):   destruye un nodo y recicla su memoria (remove)
+//  - dispose(node):   destruye un nodo dentro de una liberación masiva (clear / destructor)
+//  - reset():         se llama después de dispose() sobre TODOS los nodos vivos
+//  - concurrent_create: true si create() se puede llamar desde varios hilos a la vez
+//                      (LinearHash::bulk_build construye nodos en paralelo solo en ese caso)
+
+// Política por defecto: cada nodo se pide y se devuelve con new/delete
+template<typename Node>
+struct LinearHashNewDeleteAllocator {
+	static constexpr bool concurrent_create = true;
+	template<typename... Args>
+	Node* create(Args&&... args) {return new Node(std::forward<Args>(args)...);}
+	void destroy(Node* node) {delete node;}
+	void dispose(Node* node) {delete node;}
+	void reset() {}
+};
+
+// Pool de nodos por slabs (páginas de muchos nodos contiguos) con free list.
+//  - create() toma un hueco de la free list o avanza dentro del slab actual;
+//    solo llama a operator new cuando se llena un slab entero.
+//  - destroy() ejecuta el destructor y deja el hueco en la free list (LIFO),
+//    así el siguiente insert reutiliza memoria "caliente".
+//  - dispose() + reset() liberan en bloque: no se encadena nada en la free list,
+//    se devuelven los slabs de golpe (se conserva uno para no volver a pedirlo).
+// No es thread-safe: igual que LinearHash, se protege desde fuera.
+template<typename Node>
+class LinearHashPoolAllocator {
+	// Cada hueco es o un nodo vivo o un enlace de la free list
+	union Slot {
+		Slot* next_free;
+		alignas(Node) unsigned char storage[sizeof(Node)];
+	};
+	// Cantidad de nodos por slab: ~64 KB por página, mínimo 16 nodos
+	static constexpr size_t slab_nodes = sizeof(Slot) * 16 > 65536 ? 16 : 65536 / sizeof(Slot);
+	struct Slab {
+		Slab* next;
+		Slot slots[slab_nodes];
+	};
+
+	Slab* slabs;          // lista de slabs pedidos (el primero es el actual)
+	size_t bump;          // cantidad de huecos ya entregados del slab actual
+	Slot* free_list;      // huecos liberados por destroy()
+	size_t slab_count;    // cantidad de slabs pedidos (para estadísticas)
+
+	void add_slab() {
+		Slab* slab = static_cast<Slab*>(::operator new(sizeof(Slab)));
+		slab->next = slabs;
+		slabs = slab; bump = 0; ++slab_count;
+	}
+public:
+	static constexpr bool concurrent_create = false;
+	LinearHashPoolAllocator(): slabs(nullptr), bump(slab_nodes), free_list(nullptr), slab_count(0) {}
+	LinearHashPoolAllocator(const LinearHashPoolAllocator&) = delete;
+	LinearHashPoolAllocator& operator=(const LinearHashPoolAllocator&) = delete;
+
+	template<typename... Args>
+	Node* create(Args&&... args) {
+		Slot* slot;
+		if (free_list != nullptr) {
+			slot = free_list; free_list = free_list->next_free;
+		} else {
+			if (bump == slab_nodes) add_slab();
+			slot = &slabs->slots[bump++];
+		}
+		try {
+			return ::new (static_cast<void*>(slot->storage)) Node(std::forward<Args>(args)...);
+		} catch (...) {
+			// Si el constructor falla, el hueco vuelve a la free list
+			slot->next_free = free_list; free_list = slot;
+			throw;
+		}
+	}
+
+	void destroy(Node* node) {
+		std::destroy_at(node);
+		Slot* slot = reinterpret_cast<Slot*>(node);
+		slot->next_free = free_list; free_list = slot;
+	}
+
+	// Solo destructor: la memoria se recupera en bloque con reset()
+	void dispose(Node* node) {std::destroy_at(node);}
+
+	// Todos los nodos ya fueron destruidos: se devuelven los slabs salvo uno
+	void reset() {
+		free_list = nullptr;
+		if (slabs == nullptr) return;
+		Slab* keep = slabs;
+		Slab* curr = slabs->next;
+		while (curr != nullptr) {
+			Slab* temp = curr;
+			curr = curr->next;
+			::operator delete(temp);
+		}
+		keep->next = nullptr;
+		slabs = keep; bump = 0; slab_count = 1;
+	}
+
+	size_t slabs_in_use() const {return slab_count;}
+	size_t bytes_reserved() const {return slab_count * sizeof(Slab);}
+
+	~LinearHashPoolAllocator() {
+		while (slabs != nullptr) {
+			Slab* temp = slabs;
+			slabs = slabs->next;
+			::operator delete(temp);
+		}
+	}
+};
+
+#endif //LINEARHASH_ALLOC_H
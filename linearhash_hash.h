@@ -0,0 +1,152 @@
+#ifndef LINEARHASH_HASH_H
+#define LINEARHASH_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LINEARHASH_HASH_SSE2 1
+#endif
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Hash rápido no criptográfico para claves de bytes (tokens, correos), estilo wyhash:
+// cada paso es una multiplicación de 64x64 -> 128 bits plegada con xor ("mum"), que mezcla
+// todos los bits de entrada en todos los de salida con muy pocas instrucciones.
+//  - hasta 16 bytes: dos lecturas solapadas de 4 u 8 bytes, sin loop
+//  - 32 a 64 bytes (el formato de nuestros tokens, "<ticks>_<random>", ~40 bytes):
+//    estilo XXH3, cuatro bloques de 16 bytes (32 del principio y 32 del final, solapados
+//    si hacen falta) acumulados con multiplicaciones de 32x32 -> 64 en dos vectores SSE2;
+//    sin SSE2 el mismo cálculo carril por carril (mismo resultado en cualquier máquina)
+//  - resto: bloques de 16 o 48 bytes con mum
+// No sirve contra claves elegidas por un atacante que conozca la semilla.
+
+constexpr uint64_t linearhash_hash_secret[4] = {
+	0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+// Secreto de 64 bytes para el camino de 32 a 64 bytes (uno de 16 bytes por bloque)
+constexpr uint64_t linearhash_hash_block_secret[8] = {
+	0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+	0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull};
+
+// Multiplicación 64x64 -> 128 bits, devuelve parte baja xor parte alta
+inline uint64_t linearhash_mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = __uint128_t(a) * b;
+	return uint64_t(r) ^ uint64_t(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high;
+	uint64_t low = _umul128(a, b, &high);
+	return low ^ high;
+#else
+	uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t carry = t < rl;
+	uint64_t low = t + (rm1 << 32);
+	carry += low < t;
+	uint64_t high = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+	return low ^ high;
+#endif
+}
+
+inline uint64_t linearhash_read64(const uint8_t* p) {uint64_t v; std::memcpy(&v, p, 8); return v;}
+inline uint64_t linearhash_read32(const uint8_t* p) {uint32_t v; std::memcpy(&v, p, 4); return v;}
+
+// Claves de 32 a 64 bytes: 4 carriles de 64 bits. Por cada bloque d de 16 bytes con su
+// secreto k: x = d ^ k; acc[j] += low32(x[j]) * high32(x[j]) + d[j ^ 1].
+inline uint64_t linearhash_hash_32_64(const uint8_t* p, size_t len, uint64_t seed) {
+	const uint8_t* blocks[4] = {p, p + 16, p + len - 32, p + len - 16};
+	const uint8_t* secret = reinterpret_cast<const uint8_t*>(linearhash_hash_block_secret);
+	uint64_t acc[4];
+#if defined(LINEARHASH_HASH_SSE2)
+	__m128i acc0 = _mm_set_epi64x(int64_t(len), int64_t(seed));
+	__m128i acc1 = _mm_set_epi64x(int64_t(seed), int64_t(len));
+	for (int b = 0; b < 4; ++b) {
+		__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks[b]));
+		__m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + 16 * b));
+		__m128i x = _mm_xor_si128(data, key);
+		// _mm_mul_epu32 multiplica los 32 bits bajos de cada carril: se enfrenta x con sus 32 altos
+		__m128i product = _mm_mul_epu32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 3, 0, 1)));
+		__m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		__m128i sum = _mm_add_epi64(product, swapped);
+		if (b % 2 == 0) acc0 = _mm_add_epi64(acc0, sum);
+		else acc1 = _mm_add_epi64(acc1, sum);
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(acc), acc0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2), acc1);
+#else
+	acc[0] = seed; acc[1] = len; acc[2] = len; acc[3] = seed;
+	for (int b = 0; b < 4; ++b) {
+		uint64_t data[2] = {linearhash_read64(blocks[b]), linearhash_read64(blocks[b] + 8)};
+		uint64_t* lanes = acc + (b % 2) * 2;
+		for (int j = 0; j < 2; ++j) {
+			uint64_t x = data[j] ^ linearhash_read64(secret + 16 * b + 8 * j);
+			lanes[j] += (x & 0xffffffffull) * (x >> 32) + data[j ^ 1];
+		}
+	}
+#endif
+	uint64_t h = linearhash_mum(acc[0] ^ linearhash_hash_secret[0], acc[1] ^ linearhash_hash_secret[1]) ^
+		linearhash_mum(acc[2] ^ linearhash_hash_secret[2], acc[3] ^ linearhash_hash_secret[3]);
+	return linearhash_mum(h ^ linearhash_hash_secret[1], uint64_t(len) ^ seed ^ linearhash_hash_secret[0]);
+}
+
+inline uint64_t linearhash_hash_bytes(const void* key, size_t len, uint64_t seed = 0) {
+	const uint8_t* p = static_cast<const uint8_t*>(key);
+	const uint64_t* s = linearhash_hash_secret;
+	seed ^= linearhash_mum(seed ^ s[0], s[1]);
+	uint64_t a, b;
+	if (len <= 16) {
+		if (len >= 4) {
+			size_t shift = (len >> 3) << 2;
+			a = (linearhash_read32(p) << 32) | linearhash_read32(p + shift);
+			b = (linearhash_read32(p + len - 4) << 32) | linearhash_read32(p + len - 4 - shift);
+		} else if (len > 0) {
+			a = (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) | p[len - 1];
+			b = 0;
+		} else a = b = 0;
+	} else if (len >= 32 && len <= 64) {
+		return linearhash_hash_32_64(p, len, seed);
+	} else {
+		size_t i = len;
+		if (i > 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = linearhash_mum(linearhash_read64(p) ^ s[1], linearhash_read64(p + 8) ^ seed);
+				see1 = linearhash_mum(linearhash_read64(p + 16) ^ s[2], linearhash_read64(p + 24) ^ see1);
+				see2 = linearhash_mum(linearhash_read64(p + 32) ^ s[3], linearhash_read64(p + 40) ^ see2);
+				p += 48; i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = linearhash_mum(linearhash_read64(p) ^ s[1], linearhash_read64(p + 8) ^ seed);
+			i -= 16; p += 16;
+		}
+		a = linearhash_read64(p + i - 16);
+		b = linearhash_read64(p + i - 8);
+	}
+	a ^= s[1]; b ^= seed;
+	return linearhash_mum(s[0] ^ uint64_t(len), linearhash_mum(a, b) ^ s[1]);
+}
+
+// Hasher transparente para claves string (acepta std::string, std::string_view y const char*),
+// intercambiable con LinearHashHasher<std::string> como parámetro Hash de LinearHash
+struct LinearHashFastHasher {
+	using is_transparent = void;
+	size_t operator()(std::string_view key) const noexcept {return size_t(linearhash_hash_bytes(key.data(), key.size()));}
+};
+
+// Hasher para claves enteras (ids, contadores). std::hash de un entero es la identidad:
+// con ids consecutivos los bits altos quedan en 0 y ShardedLinearHash, que elige el shard con
+// ellos, mandaría todo al mismo shard. Una multiplicación reparte los bits en todo el hash.
+struct LinearHashIntHasher {
+	size_t operator()(uint64_t key) const noexcept {
+		return size_t(linearhash_mum(key ^ linearhash_hash_secret[0], linearhash_hash_secret[1]));
+	}
+};
+
+#endif //LINEARHASH_HASH_H
@@ -0,0 +1,84 @@
+#ifndef LINEARHASH_INDEX_H
+#define LINEARHASH_INDEX_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "shardedlinearhash.h"
+
+// Índice secundario: clave secundaria (TK) -> conjunto de claves de la tabla principal (TRef),
+// por ejemplo correo -> tokens de sus sesiones. Responde en O(referencias de esa clave) lo que
+// sobre la tabla principal sería un recorrido completo.
+//  - Por dentro es un ShardedLinearHash<TK, vector<TRef>>: cada operación toma el lock de
+//    un solo shard y modifica el vector en el lugar (upsert / update).
+//  - Cada vector se mantiene ordenado con RefLess: el primero es el "más chico" (para
+//    SessionId, el más viejo), que es el que se descarta al pasarse de max_refs.
+//  - Los vectores son chicos (las sesiones de un usuario): insertar ordenado es un memmove.
+// El índice no sabe nada de la tabla principal: quien la modifica tiene que avisarle
+// (add / remove / take / clear). Nunca se llama a otra tabla con el lock del índice tomado,
+// así que el índice se puede actualizar desde adentro de un callback de la tabla principal.
+template<typename TK, typename TRef, typename Hash = LinearHashHasher<TK>, typename RefLess = std::less<>>
+class LinearHashSecondaryIndex {
+	ShardedLinearHash<TK, std::vector<TRef>, Hash> entries;
+	RefLess less;
+
+public:
+	explicit LinearHashSecondaryIndex(size_t shard_count, int M0=4): entries(shard_count, M0) {}
+	LinearHashSecondaryIndex(const LinearHashSecondaryIndex&) = delete;
+	LinearHashSecondaryIndex& operator=(const LinearHashSecondaryIndex&) = delete;
+
+	// Agrega ref a key. Si max_refs != 0 y key queda con más referencias, saca las más chicas
+	// y las devuelve (quien llama las borra de la tabla principal)
+	std::vector<TRef> add(const TK& key, const TRef& ref, size_t max_refs = 0) {
+		return entries.upsert(key, [&](std::vector<TRef>& refs) {
+			auto at = std::upper_bound(refs.begin(), refs.end(), ref, less);
+			if (at == refs.begin() || less(*(at - 1), ref)) refs.insert(at, ref);
+			std::vector<TRef> dropped;
+			if (max_refs != 0 && refs.size() > max_refs) {
+				auto keep = refs.end() - std::ptrdiff_t(max_refs);
+				dropped.assign(refs.begin(), keep);
+				refs.erase(refs.begin(), keep);
+			}
+			return dropped;
+		});
+	}
+
+	// Saca ref de key; false si no estaba. La entrada de key desaparece con su última referencia.
+	bool remove(const TK& key, const TRef& ref) {
+		bool removed = false;
+		entries.update(key, [&](std::vector<TRef>& refs) {
+			auto at = std::lower_bound(refs.begin(), refs.end(), ref, less);
+			if (at != refs.end() && !less(ref, *at)) {
+				refs.erase(at);
+				removed = true;
+			}
+			return !refs.empty();
+		});
+		return removed;
+	}
+
+	// Saca y devuelve todas las referencias de key (ordenadas)
+	std::vector<TRef> take(const TK& key) {
+		std::vector<TRef> taken;
+		entries.update(key, [&taken](std::vector<TRef>& refs) {
+			taken = std::move(refs);
+			return false;
+		});
+		return taken;
+	}
+
+	// Copia de las referencias de key (ordenadas)
+	std::vector<TRef> get(const TK& key) {
+		std::vector<TRef> refs;
+		entries.try_get(key, refs);
+		return refs;
+	}
+
+	// Cantidad de claves secundarias con al menos una referencia
+	int key_count() {return entries.size();}
+
+	void clear() {entries.clear();}
+};
+
+#endif //LINEARHASH_INDEX_H
@@ -0,0 +1,144 @@
+#ifndef LINEARHASH_SNAPSHOT_H
+#define LINEARHASH_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Formato binario de snapshot de LinearHash (todo en el orden de bytes de la máquina):
+//   LinearHashSnapshotHeader
+//   offsets: (bucketcount + 1) x uint64, inicio de cada bucket dentro del cuerpo
+//   cuerpo:  por cada bucket, sus registros: hash (uint64) + clave + valor
+// Las claves y valores se escriben con serializadores enchufables (LinearHashSerializer<T>
+// o los que se pasen como parámetro de template). Como el hash va guardado y el header
+// trae M0 / i / p, la carga arma los buckets tal cual sin volver a hashear nada
+// (si el hasher de quien carga coincide con el de quien guardó; ver hash_fingerprint).
+
+struct LinearHashSnapshotHeader {
+	char magic[8];               // "LHSNAP01"
+	uint32_t byte_order;         // linearhash_snapshot_byte_order en la máquina que lo escribió
+	uint32_t size_t_bytes;       // sizeof(size_t) al guardar
+	uint64_t hash_fingerprint;   // hash de una clave fija: detecta un hasher distinto
+	uint64_t M0, i, p, bucketcount, datacount;
+	uint64_t body_bytes;
+};
+
+constexpr char linearhash_snapshot_magic[8] = {'L', 'H', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr uint32_t linearhash_snapshot_byte_order = 0x01020304;
+
+inline void linearhash_snapshot_check(bool condition, const char* what) {
+	if (!condition) throw std::runtime_error(std::string("LinearHash snapshot: ") + what);
+}
+
+// Serializador de un tipo T:
+//   static void write(std::string& out, const T& value)            agrega los bytes a out
+//   static const char* read(const char* in, const char* end, T& value)  devuelve dónde sigue
+// read() debe lanzar si los datos no alcanzan (archivo truncado o corrupto).
+template<typename T>
+struct LinearHashSerializer;
+
+// Tipos trivialmente copiables: bytes tal cual
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+struct LinearHashSerializer<T> {
+	static void write(std::string& out, const T& value) {
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+	static const char* read(const char* in, const char* end, T& value) {
+		linearhash_snapshot_check(size_t(end - in) >= sizeof(T), "truncated value");
+		std::memcpy(&value, in, sizeof(T));
+		return in + sizeof(T);
+	}
+};
+
+// std::string: largo (uint32) + bytes
+template<>
+struct LinearHashSerializer<std::string> {
+	static void write(std::string& out, const std::string& value) {
+		LinearHashSerializer<uint32_t>::write(out, uint32_t(value.size()));
+		out.append(value);
+	}
+	static const char* read(const char* in, const char* end, std::string& value) {
+		uint32_t length;
+		in = LinearHashSerializer<uint32_t>::read(in, end, length);
+		linearhash_snapshot_check(size_t(end - in) >= length, "truncated string");
+		value.assign(in, length);
+		return in + length;
+	}
+};
+
+// Archivo mapeado en memoria de solo lectura (mmap / MapViewOfFile).
+// La carga lee directo de las páginas del archivo, sin copiarlo a un buffer.
+class LinearHashMappedFile {
+	const char* bytes = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#endif
+public:
+	explicit LinearHashMappedFile(const std::string& path) {
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+						   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+		LARGE_INTEGER file_size;
+		GetFileSizeEx(file, &file_size);
+		length = size_t(file_size.QuadPart);
+		if (length > 0) {
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr) bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			if (bytes == nullptr) {close(); throw std::runtime_error("cannot map " + path);}
+		}
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("cannot open " + path);
+		struct stat info;
+		if (::fstat(fd, &info) != 0) {::close(fd); throw std::runtime_error("cannot stat " + path);}
+		length = size_t(info.st_size);
+		if (length > 0) {
+			void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (address == MAP_FAILED) {::close(fd); throw std::runtime_error("cannot map " + path);}
+			// Se va a leer todo: que el kernel lo traiga por adelantado
+			::madvise(address, length, MADV_WILLNEED);
+			bytes = static_cast<const char*>(address);
+		}
+		::close(fd);   // el mapeo sigue vivo sin el descriptor
+#endif
+	}
+	LinearHashMappedFile(const LinearHashMappedFile&) = delete;
+	LinearHashMappedFile& operator=(const LinearHashMappedFile&) = delete;
+
+	const char* data() const {return bytes;}
+	size_t size() const {return length;}
+
+	void close() {
+#ifdef _WIN32
+		if (bytes != nullptr) UnmapViewOfFile(bytes);
+		if (mapping != nullptr) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		mapping = nullptr; file = INVALID_HANDLE_VALUE;
+#else
+		if (bytes != nullptr) ::munmap(const_cast<char*>(bytes), length);
+#endif
+		bytes = nullptr; length = 0;
+	}
+	~LinearHashMappedFile() {close();}
+};
+
+#endif //LINEARHASH_SNAPSHOT_H
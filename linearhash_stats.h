@@ -0,0 +1,203 @@
+#ifndef LINEARHASH_STATS_H
+#define LINEARHASH_STATS_H
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include "epoch.h"
+
+// Políticas de estadísticas para LinearHash (parámetro de template Stats).
+// La tabla llama siempre a las mismas funciones:
+//  - record_probe(op, pasos): una operación terminó después de mirar "pasos" nodos
+//  - timer() / record_split(timer) / record_merge(timer): duración de cada split/merge
+//  - snapshot(): suma de todos los contadores hasta ahora
+// LinearHashNoStats no hace nada (todo inline y vacío: el compilador lo borra, incluso
+// los contadores locales de pasos). LinearHashFullStats guarda contadores de 64 bits
+// por hilo, así que se puede usar desde varios hilos sin carreras ni contención.
+
+enum class LinearHashOp {get, insert, remove};
+constexpr int linearhash_op_count = 3;
+
+// Histograma de probes / largo de cadena: 0..15 exacto, el último bin cuenta >= 16
+constexpr int linearhash_length_bins = 17;
+// Histograma de duraciones: bin k = [2^k, 2^(k+1)) nanosegundos
+constexpr int linearhash_time_bins = 40;
+
+inline int linearhash_length_bin(uint64_t length) {
+	return length >= uint64_t(linearhash_length_bins - 1) ? linearhash_length_bins - 1 : int(length);
+}
+inline int linearhash_time_bin(uint64_t ns) {
+	int bin = ns == 0 ? 0 : std::bit_width(ns) - 1;
+	return bin >= linearhash_time_bins ? linearhash_time_bins - 1 : bin;
+}
+
+// Foto de los contadores (ya sumados entre hilos); se pueden sumar entre tablas/shards
+struct LinearHashStatsSnapshot {
+	bool enabled = false;
+	uint64_t ops[linearhash_op_count] = {};
+	uint64_t probes[linearhash_op_count] = {};
+	uint64_t probe_histogram[linearhash_op_count][linearhash_length_bins] = {};
+	uint64_t splits = 0, merges = 0;
+	uint64_t split_ns = 0, merge_ns = 0;
+	uint64_t split_histogram[linearhash_time_bins] = {};
+	uint64_t merge_histogram[linearhash_time_bins] = {};
+	// Largo de cadena de cada bucket activo (lo llena la tabla recorriendo sus buckets)
+	uint64_t chain_histogram[linearhash_length_bins] = {};
+
+	LinearHashStatsSnapshot& operator+=(const LinearHashStatsSnapshot& other) {
+		enabled = enabled || other.enabled;
+		for (int op = 0; op < linearhash_op_count; ++op) {
+			ops[op] += other.ops[op];
+			probes[op] += other.probes[op];
+			for (int b = 0; b < linearhash_length_bins; ++b) probe_histogram[op][b] += other.probe_histogram[op][b];
+		}
+		splits += other.splits; merges += other.merges;
+		split_ns += other.split_ns; merge_ns += other.merge_ns;
+		for (int b = 0; b < linearhash_time_bins; ++b) {
+			split_histogram[b] += other.split_histogram[b];
+			merge_histogram[b] += other.merge_histogram[b];
+		}
+		for (int b = 0; b < linearhash_length_bins; ++b) chain_histogram[b] += other.chain_histogram[b];
+		return *this;
+	}
+
+	uint64_t total_probes() const {return probes[0] + probes[1] + probes[2];}
+
+	void print(std::ostream& out) const {
+		if (!enabled) {out << "estadisticas desactivadas (LinearHashNoStats)\n"; return;}
+		const char* names[linearhash_op_count] = {"get", "insert", "remove"};
+		for (int op = 0; op < linearhash_op_count; ++op) {
+			out << names[op] << ": ops=" << ops[op] << " probes=" << probes[op]
+				<< " promedio=" << (ops[op] ? double(probes[op]) / ops[op] : 0.0) << "\n  probes/op:";
+			print_lengths(out, probe_histogram[op]);
+		}
+		out << "split: " << splits << " (" << split_ns << " ns en total)\n  ns:";
+		print_times(out, split_histogram);
+		out << "merge: " << merges << " (" << merge_ns << " ns en total)\n  ns:";
+		print_times(out, merge_histogram);
+		out << "largo de cadena:";
+		print_lengths(out, chain_histogram);
+	}
+
+private:
+	static void print_lengths(std::ostream& out, const uint64_t (&histogram)[linearhash_length_bins]) {
+		for (int b = 0; b < linearhash_length_bins; ++b) {
+			if (histogram[b] == 0) continue;
+			out << " " << b << (b == linearhash_length_bins - 1 ? "+" : "") << "=" << histogram[b];
+		}
+		out << "\n";
+	}
+	static void print_times(std::ostream& out, const uint64_t (&histogram)[linearhash_time_bins]) {
+		for (int b = 0; b < linearhash_time_bins; ++b) {
+			if (histogram[b] == 0) continue;
+			out << " <" << (uint64_t(1) << (b + 1)) << "=" << histogram[b];
+		}
+		out << "\n";
+	}
+};
+
+// Producción: no cuesta nada
+struct LinearHashNoStats {
+	static constexpr bool enabled = false;
+	struct Timer {};
+	void record_probe(LinearHashOp, uint64_t) {}
+	Timer timer() {return {};}
+	void record_split(Timer) {}
+	void record_merge(Timer) {}
+	LinearHashStatsSnapshot snapshot() {return {};}
+};
+
+// Staging: contadores por hilo. Cada hilo escribe solo en su propio slot (índice de
+// EpochThreadRegistry), que se crea la primera vez que ese hilo toca la tabla.
+// Los contadores son atómicos con un único escritor: se actualizan con load + store
+// relajados (sin instrucciones con lock) y snapshot() los puede leer desde otro hilo.
+class LinearHashFullStats {
+	typedef std::atomic<uint64_t> Counter;
+	struct alignas(64) Slot {
+		Counter ops[linearhash_op_count] = {};
+		Counter probes[linearhash_op_count] = {};
+		Counter probe_histogram[linearhash_op_count][linearhash_length_bins] = {};
+		Counter splits{0}, merges{0}, split_ns{0}, merge_ns{0};
+		Counter split_histogram[linearhash_time_bins] = {};
+		Counter merge_histogram[linearhash_time_bins] = {};
+	};
+	std::unique_ptr<std::atomic<Slot*>[]> slots;
+
+	static void bump(Counter& counter, uint64_t amount = 1) {
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+	Slot& local() {
+		std::atomic<Slot*>& entry = slots[EpochThreadRegistry::slot()];
+		Slot* slot = entry.load(std::memory_order_acquire);
+		if (slot == nullptr) {
+			// Solo este hilo crea su slot (el índice es suyo mientras viva)
+			slot = new Slot();
+			entry.store(slot, std::memory_order_release);
+		}
+		return *slot;
+	}
+	static uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count());
+	}
+
+public:
+	static constexpr bool enabled = true;
+	typedef std::chrono::steady_clock::time_point Timer;
+
+	LinearHashFullStats(): slots(new std::atomic<Slot*>[EpochThreadRegistry::max_threads]) {
+		for (int t = 0; t < EpochThreadRegistry::max_threads; ++t) slots[t].store(nullptr, std::memory_order_relaxed);
+	}
+	LinearHashFullStats(const LinearHashFullStats&) = delete;
+	LinearHashFullStats& operator=(const LinearHashFullStats&) = delete;
+	~LinearHashFullStats() {
+		for (int t = 0; t < EpochThreadRegistry::max_threads; ++t) delete slots[t].load(std::memory_order_relaxed);
+	}
+
+	void record_probe(LinearHashOp op, uint64_t steps) {
+		Slot& slot = local();
+		int o = int(op);
+		bump(slot.ops[o]);
+		bump(slot.probes[o], steps);
+		bump(slot.probe_histogram[o][linearhash_length_bin(steps)]);
+	}
+	Timer timer() {return std::chrono::steady_clock::now();}
+	void record_split(Timer start) {
+		uint64_t ns = elapsed_ns(start);
+		Slot& slot = local();
+		bump(slot.splits); bump(slot.split_ns, ns);
+		bump(slot.split_histogram[linearhash_time_bin(ns)]);
+	}
+	void record_merge(Timer start) {
+		uint64_t ns = elapsed_ns(start);
+		Slot& slot = local();
+		bump(slot.merges); bump(slot.merge_ns, ns);
+		bump(slot.merge_histogram[linearhash_time_bin(ns)]);
+	}
+
+	LinearHashStatsSnapshot snapshot() {
+		LinearHashStatsSnapshot result;
+		result.enabled = true;
+		auto read = [](const Counter& counter) {return counter.load(std::memory_order_relaxed);};
+		for (int t = 0; t < EpochThreadRegistry::max_threads; ++t) {
+			const Slot* slot = slots[t].load(std::memory_order_acquire);
+			if (slot == nullptr) continue;
+			for (int op = 0; op < linearhash_op_count; ++op) {
+				result.ops[op] += read(slot->ops[op]);
+				result.probes[op] += read(slot->probes[op]);
+				for (int b = 0; b < linearhash_length_bins; ++b) result.probe_histogram[op][b] += read(slot->probe_histogram[op][b]);
+			}
+			result.splits += read(slot->splits); result.merges += read(slot->merges);
+			result.split_ns += read(slot->split_ns); result.merge_ns += read(slot->merge_ns);
+			for (int b = 0; b < linearhash_time_bins; ++b) {
+				result.split_histogram[b] += read(slot->split_histogram[b]);
+				result.merge_histogram[b] += read(slot->merge_histogram[b]);
+			}
+		}
+		return result;
+	}
+};
+
+#endif //LINEARHASH_STATS_H
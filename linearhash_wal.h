@@ -0,0 +1,385 @@
+#ifndef LINEARHASH_WAL_H
+#define LINEARHASH_WAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "linearhash_snapshot.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Write-ahead log para una tabla clave -> valor: registros de insert / remove / clear
+// agregados al final de un archivo. Formato:
+//   magic "LHWAL001"
+//   registros: largo del cuerpo (uint32) + checksum del cuerpo (uint32) + cuerpo
+//   cuerpo:    tipo (uint8) + largo de la clave (uint32) + clave + valor
+// Clave y valor van con los mismos serializadores de los snapshots.
+//
+// Group commit: log_insert / log_remove / log_clear solo copian el registro a un buffer
+// en memoria (no tocan el disco). Un hilo dedicado junta lo que llegó durante la
+// "ventana de durabilidad", lo escribe de una vez y hace un solo fdatasync para todo el
+// lote. Una sesión puede perderse solo si el proceso cae dentro de esa ventana.
+//
+// Checkpoint (junto con el snapshot de la tabla):
+//   1. rotate(): el log actual pasa a "<log>.old" y se empieza uno vacío
+//   2. se guarda el snapshot
+//   3. remove_rotated(): se borra "<log>.old"
+// Al arrancar: snapshot, replay de "<log>.old" (si quedó de un checkpoint cortado) y
+// replay de "<log>". Como insert pisa y remove / clear son idempotentes, repetir sobre
+// un snapshot más nuevo operaciones que ya estaban adentro deja la tabla igual.
+
+enum class LinearHashWalOp : uint8_t {insert = 1, remove = 2, clear = 3};
+
+constexpr char linearhash_wal_magic[8] = {'L', 'H', 'W', 'A', 'L', '0', '0', '1'};
+
+// FNV-1a de 32 bits: alcanza para detectar un registro cortado o basura al final del log
+inline uint32_t linearhash_wal_checksum(const char* data, size_t length) {
+	uint32_t h = 2166136261u;
+	for (size_t k = 0; k < length; ++k) {
+		h ^= uint8_t(data[k]);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+template<typename TK, typename TV, typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+class LinearHashWal {
+	static constexpr size_t record_header = 8;   // largo + checksum
+
+	std::string path;
+	std::chrono::microseconds window{0};
+	int fd = -1;
+	std::thread writer;
+
+	// Protege pending, appended, durable y stop. Los handlers lo toman solo para copiar bytes.
+	std::mutex mutex;
+	std::condition_variable wake;      // hay registros nuevos (o hay que parar)
+	std::condition_variable synced;    // avanzó "durable"
+	std::string pending;               // registros que todavía no se escribieron
+	uint64_t appended = 0;             // registros agregados hasta ahora
+	uint64_t durable = 0;              // registros que ya pasaron por fdatasync
+	bool stop = false;
+	// El hilo escritor lo toma mientras escribe y sincroniza; rotate() lo toma para cambiar de archivo
+	std::mutex file_mutex;
+	std::atomic<uint64_t> batches{0};
+
+	static void write_u32(std::string& out, uint32_t value) {out.append(reinterpret_cast<const char*>(&value), 4);}
+	static uint32_t read_u32(const char* at) {uint32_t v; std::memcpy(&v, at, 4); return v;}
+
+	static int open_file(const std::string& file) {
+#ifdef _WIN32
+		int descriptor = ::_open(file.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, 0644);
+#else
+		int descriptor = ::open(file.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+#endif
+		if (descriptor < 0) throw std::runtime_error("LinearHashWal: cannot open " + file);
+		return descriptor;
+	}
+	static void close_file(int descriptor) {
+#ifdef _WIN32
+		::_close(descriptor);
+#else
+		::close(descriptor);
+#endif
+	}
+	static bool write_all(int descriptor, const char* data, size_t length) {
+		while (length > 0) {
+#ifdef _WIN32
+			int written = ::_write(descriptor, data, unsigned(std::min<size_t>(length, 1u << 30)));
+#else
+			ssize_t written = ::write(descriptor, data, length);
+#endif
+			if (written <= 0) return false;
+			data += written;
+			length -= size_t(written);
+		}
+		return true;
+	}
+	static bool sync_file(int descriptor) {
+#ifdef _WIN32
+		return ::_commit(descriptor) == 0;
+#elif defined(__APPLE__)
+		return ::fsync(descriptor) == 0;
+#else
+		return ::fdatasync(descriptor) == 0;
+#endif
+	}
+
+	// Archivo nuevo o vacío: se le pone el magic antes del primer registro
+	static int open_log(const std::string& file) {
+		bool empty = !std::filesystem::exists(file) || std::filesystem::file_size(file) == 0;
+		int descriptor = open_file(file);
+		if (empty && (!write_all(descriptor, linearhash_wal_magic, sizeof(linearhash_wal_magic)) || !sync_file(descriptor))) {
+			close_file(descriptor);
+			throw std::runtime_error("LinearHashWal: cannot initialize " + file);
+		}
+		return descriptor;
+	}
+
+	void append(LinearHashWalOp op, const std::string* key_bytes, const std::string* value_bytes) {
+		std::string record;
+		record.resize(record_header);
+		record.push_back(char(op));
+		write_u32(record, uint32_t(key_bytes ? key_bytes->size() : 0));
+		if (key_bytes) record += *key_bytes;
+		if (value_bytes) record += *value_bytes;
+		uint32_t body = uint32_t(record.size() - record_header);
+		uint32_t checksum = linearhash_wal_checksum(record.data() + record_header, body);
+		std::memcpy(&record[0], &body, 4);
+		std::memcpy(&record[4], &checksum, 4);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (fd < 0) throw std::logic_error("LinearHashWal: log not open");
+			bool was_empty = pending.empty();
+			pending += record;
+			++appended;
+			if (!was_empty) return;   // el escritor ya está juntando este lote
+		}
+		wake.notify_one();
+	}
+
+	// Hilo de group commit: espera el primer registro, deja pasar la ventana para juntar
+	// más, escribe todo junto y hace un solo fdatasync
+	void writer_loop() {
+		std::string writing;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			wake.wait(lock, [&] {return stop || !pending.empty() || !writing.empty();});
+			if (stop && pending.empty() && writing.empty()) break;
+			if (!stop && window.count() > 0) wake.wait_for(lock, window, [&] {return stop;});
+			// Si el lote anterior falló, sigue en "writing" y se reintenta con lo nuevo detrás
+			writing += pending;
+			pending.clear();
+			uint64_t batch_end = appended;
+			std::unique_lock<std::mutex> file_lock(file_mutex);
+			lock.unlock();
+			bool ok = write_all(fd, writing.data(), writing.size()) && sync_file(fd);
+			file_lock.unlock();
+			lock.lock();
+			if (!ok) {
+				std::cerr << "[WAL][ERROR] no se pudo escribir " << path << ", se reintenta\n";
+				if (stop) {pending.insert(0, writing); break;}
+				wake.wait_for(lock, std::chrono::milliseconds(100), [&] {return stop;});
+				continue;
+			}
+			writing.clear();
+			batches.fetch_add(1, std::memory_order_relaxed);
+			durable = std::max(durable, batch_end);   // rotate() pudo adelantarse
+			synced.notify_all();
+		}
+	}
+
+public:
+	LinearHashWal() = default;
+	LinearHashWal(const LinearHashWal&) = delete;
+	LinearHashWal& operator=(const LinearHashWal&) = delete;
+
+	// Abre (o crea) el log y arranca el hilo de group commit. window: cuánto puede esperar
+	// un registro antes de llegar al disco (0 = se sincroniza apenas llega).
+	// Antes de abrir hay que hacer replay: open() agrega al final de lo que haya.
+	void open(const std::string& file, std::chrono::microseconds durability_window) {
+		if (fd >= 0) throw std::logic_error("LinearHashWal: already open");
+		path = file;
+		window = durability_window;
+		fd = open_log(path);
+		stop = false;
+		writer = std::thread(&LinearHashWal::writer_loop, this);
+	}
+
+	void log_insert(const TK& key, const TV& value) {
+		std::string key_bytes, value_bytes;
+		KeySer::write(key_bytes, key);
+		ValueSer::write(value_bytes, value);
+		append(LinearHashWalOp::insert, &key_bytes, &value_bytes);
+	}
+	void log_remove(const TK& key) {
+		std::string key_bytes;
+		KeySer::write(key_bytes, key);
+		append(LinearHashWalOp::remove, &key_bytes, nullptr);
+	}
+	void log_clear() {append(LinearHashWalOp::clear, nullptr, nullptr);}
+
+	// Bloquea hasta que todo lo registrado hasta ahora esté en disco
+	void flush() {
+		std::unique_lock<std::mutex> lock(mutex);
+		uint64_t target = appended;
+		wake.notify_one();
+		synced.wait(lock, [&] {return durable >= target || writer.get_id() == std::thread::id();});
+	}
+
+	// Primer paso del checkpoint: el log actual pasa a "<log>.old" (ya sincronizado) y los
+	// registros nuevos van a un archivo vacío. Devuelve false (y no rota) si todavía existe
+	// un .old de un checkpoint anterior que no terminó: ese se borra recién con un snapshot bueno.
+	bool rotate() {
+		flush();
+		std::lock_guard<std::mutex> lock(mutex);
+		std::lock_guard<std::mutex> file_lock(file_mutex);
+		std::string old = rotated_path();
+		if (std::filesystem::exists(old)) return false;
+		// Lo que llegó después del flush también va al log viejo
+		if (!pending.empty()) {
+			if (!write_all(fd, pending.data(), pending.size()) || !sync_file(fd))
+				throw std::runtime_error("LinearHashWal: cannot write " + path);
+			pending.clear();
+			durable = appended;
+			synced.notify_all();
+		}
+		close_file(fd);
+		std::filesystem::rename(path, old);
+		fd = open_log(path);
+		return true;
+	}
+	// Último paso del checkpoint, después de guardar el snapshot
+	void remove_rotated() {
+		std::filesystem::remove(rotated_path());
+	}
+
+	std::string rotated_path() const {return path + ".old";}
+	// Lotes escritos (cada uno con un solo fdatasync) y registros agregados
+	uint64_t batch_count() const {return batches.load(std::memory_order_relaxed);}
+	uint64_t record_count() {std::lock_guard<std::mutex> lock(mutex); return appended;}
+
+	// Aplica el log "file" con varios hilos. Devuelve la cantidad de registros válidos.
+	//  - Si termina en un registro cortado o corrupto (caída a mitad de una escritura),
+	//    se ignora desde ahí y se trunca el archivo, para que los registros nuevos no
+	//    queden detrás de la basura.
+	//  - Solo importa lo que vino después del último clear: on_clear se llama una vez
+	//    y los registros anteriores ni se decodifican.
+	//  - Cada clave se asigna a un hilo por el hash de sus bytes, así que sus operaciones
+	//    se aplican en el orden del log; on_insert / on_remove se llaman desde varios
+	//    hilos a la vez (la tabla tiene que ser thread-safe, como ShardedLinearHash).
+	static size_t replay(const std::string& file, unsigned threads,
+						 const std::function<void(TK&&, TV&&)>& on_insert,
+						 const std::function<void(const TK&)>& on_remove,
+						 const std::function<void()>& on_clear) {
+		if (!std::filesystem::exists(file)) return 0;
+		struct Entry {
+			const char* body;
+			uint32_t length;
+			uint32_t checksum;
+			unsigned owner;
+		};
+		std::vector<Entry> entries;
+		size_t valid_bytes = sizeof(linearhash_wal_magic);
+		{
+			LinearHashMappedFile mapped(file);
+			const char* data = mapped.data();
+			size_t size = mapped.size();
+			if (size < sizeof(linearhash_wal_magic)) {
+				// Se cortó al crearlo: queda vacío y open() le vuelve a poner el magic
+				std::filesystem::resize_file(file, 0);
+				return 0;
+			}
+			if (std::memcmp(data, linearhash_wal_magic, sizeof(linearhash_wal_magic)) != 0)
+				throw std::runtime_error("LinearHashWal: " + file + " is not a write-ahead log");
+			// Pasada secuencial: solo los largos, para saber dónde empieza cada registro
+			size_t at = sizeof(linearhash_wal_magic);
+			while (size - at >= record_header) {
+				uint32_t length = read_u32(data + at);
+				if (length < 5 || size - at - record_header < length) break;
+				entries.push_back({data + at + record_header, length, read_u32(data + at + 4), 0});
+				at += record_header + length;
+			}
+			if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+			threads = unsigned(std::min<size_t>(threads, std::max<size_t>(1, entries.size() / 1024)));
+			auto run = [&](auto&& work) {
+				if (threads == 1) {work(0u); return;}
+				std::vector<std::thread> workers;
+				std::vector<std::exception_ptr> errors(threads);
+				for (unsigned t = 0; t < threads; ++t) {
+					workers.emplace_back([&, t] {
+						try {work(t);} catch (...) {errors[t] = std::current_exception();}
+					});
+				}
+				for (std::thread& worker : workers) worker.join();
+				for (std::exception_ptr& error : errors) if (error) std::rethrow_exception(error);
+			};
+			// En paralelo: checksums y a qué hilo va cada registro. El primero inválido corta el log.
+			std::atomic<size_t> first_bad{entries.size()};
+			run([&](unsigned t) {
+				size_t chunk = (entries.size() + threads - 1) / threads;
+				size_t end = std::min(entries.size(), (t + 1) * chunk);
+				for (size_t e = t * chunk; e < end; ++e) {
+					Entry& entry = entries[e];
+					uint32_t key_length = read_u32(entry.body + 1);
+					uint8_t op = uint8_t(entry.body[0]);
+					if (linearhash_wal_checksum(entry.body, entry.length) != entry.checksum ||
+						op < uint8_t(LinearHashWalOp::insert) || op > uint8_t(LinearHashWalOp::clear) ||
+						key_length > entry.length - 5) {
+						size_t seen = first_bad.load();
+						while (e < seen && !first_bad.compare_exchange_weak(seen, e)) {}
+						break;
+					}
+					entry.owner = unsigned(std::hash<std::string_view>{}(std::string_view(entry.body + 5, key_length)) % threads);
+				}
+			});
+			entries.resize(first_bad.load());
+			valid_bytes = entries.empty() ? sizeof(linearhash_wal_magic)
+				: size_t(entries.back().body + entries.back().length - data);
+			// Solo cuenta lo que viene después del último clear
+			size_t start = 0;
+			for (size_t e = entries.size(); e-- > 0;) {
+				if (uint8_t(entries[e].body[0]) == uint8_t(LinearHashWalOp::clear)) {start = e + 1; break;}
+			}
+			if (start > 0) on_clear();
+			run([&](unsigned t) {
+				for (size_t e = start; e < entries.size(); ++e) {
+					const Entry& entry = entries[e];
+					if (entry.owner != t) continue;
+					const char* in = entry.body + 5;
+					const char* end = entry.body + entry.length;
+					const char* key_end = in + read_u32(entry.body + 1);
+					TK key;
+					KeySer::read(in, key_end, key);
+					if (uint8_t(entry.body[0]) == uint8_t(LinearHashWalOp::insert)) {
+						TV value;
+						ValueSer::read(key_end, end, value);
+						on_insert(std::move(key), std::move(value));
+					} else on_remove(key);
+				}
+			});
+		}
+		if (valid_bytes < std::filesystem::file_size(file)) std::filesystem::resize_file(file, valid_bytes);
+		return entries.size();
+	}
+
+	// Escribe lo pendiente y para el hilo de group commit
+	void close() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (fd < 0) return;
+			stop = true;
+		}
+		wake.notify_one();
+		if (writer.joinable()) writer.join();
+		std::lock_guard<std::mutex> lock(mutex);
+		// Si el último lote falló, se intenta una vez más
+		if (!pending.empty() && write_all(fd, pending.data(), pending.size()) && sync_file(fd)) durable = appended;
+		pending.clear();
+		close_file(fd);
+		fd = -1;
+		synced.notify_all();
+	}
+
+	~LinearHashWal() {close();}
+};
+
+#endif //LINEARHASH_WAL_H
@@ -0,0 +1,608 @@
+#ifndef LINEARHASHFILE_H
+#define LINEARHASHFILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "linearhash.h"
+
+// Linear Hashing en disco (el uso original de Litwin): la tabla vive en un archivo de
+// páginas de tamaño fijo y en memoria solo quedan las páginas calientes.
+//  - Página 0: cabecera del archivo (M0, i, p, contadores, free list, directorio).
+//  - Cada bucket tiene una página primaria y, si se llena, una cadena de páginas de overflow.
+//  - El directorio (bucket -> página primaria) se guarda en su propia cadena de páginas.
+//  - Las páginas liberadas por merge o por overflow vacío van a una free list y se reusan.
+//  - Todas las lecturas/escrituras pasan por un buffer pool de tamaño configurable
+//    con reemplazo CLOCK; las páginas sucias se escriben al desalojarlas o en flush().
+//  - Split y merge trabajan a nivel de página con el mismo esquema p / i que LinearHash;
+//    el factor de carga es bytes de registros / (buckets * bytes útiles por página).
+// No es thread-safe (igual que LinearHash, se protege desde fuera) y flush() no hace
+// fsync: la durabilidad ante cortes de luz queda para el WAL.
+
+// Operaciones a las que se atribuye la E/S
+enum class LinearHashFileOp {get, insert, remove, split, merge, flush};
+constexpr int linearhash_file_op_count = 6;
+
+// Contadores de E/S por tipo de operación: lecturas y escrituras de páginas en disco
+// y aciertos del buffer pool. La E/S de un split que dispara un insert se cuenta en split.
+struct LinearHashFileIOStats {
+	uint64_t ops[linearhash_file_op_count] = {};
+	uint64_t reads[linearhash_file_op_count] = {};
+	uint64_t writes[linearhash_file_op_count] = {};
+	uint64_t hits[linearhash_file_op_count] = {};
+
+	void print(std::ostream& out) const {
+		const char* names[linearhash_file_op_count] = {"get", "insert", "remove", "split", "merge", "flush"};
+		for (int op = 0; op < linearhash_file_op_count; ++op) {
+			if (ops[op] == 0) continue;
+			out << names[op] << ": ops=" << ops[op] << " lecturas=" << reads[op] << " escrituras=" << writes[op]
+				<< " aciertos=" << hits[op]
+				<< " E/S por op=" << double(reads[op] + writes[op]) / double(ops[op]) << "\n";
+		}
+	}
+};
+
+// Buffer pool de páginas con reemplazo CLOCK (aproximación de LRU: cada acceso marca la
+// página; la aguja desaloja la primera página no fijada y no marcada, desmarcando al pasar).
+class LinearHashBufferPool {
+	struct Frame {
+		uint64_t page_id = 0;
+		bool used = false;
+		bool dirty = false;
+		bool referenced = false;
+		int pins = 0;
+		std::unique_ptr<char[]> data;
+	};
+	std::fstream& file;
+	uint32_t page_size;
+	std::vector<Frame> frames;
+	std::unordered_map<uint64_t, size_t> page_table;   // página -> frame
+	size_t hand = 0;
+	LinearHashFileIOStats& io;
+	LinearHashFileOp& current;   // operación a la que se cargan las E/S
+
+	void write_frame(Frame& frame) {
+		file.seekp(std::streamoff(frame.page_id * page_size));
+		file.write(frame.data.get(), page_size);
+		if (!file) throw std::runtime_error("LinearHashFile: page write failed");
+		frame.dirty = false;
+		++io.writes[int(current)];
+	}
+
+	// Elige un frame libre o desaloja uno con CLOCK
+	size_t victim() {
+		for (size_t sweep = 0; sweep < 2 * frames.size() + 1; ++sweep) {
+			Frame& frame = frames[hand];
+			size_t index = hand;
+			hand = (hand + 1) % frames.size();
+			if (!frame.used) return index;
+			if (frame.pins > 0) continue;
+			if (frame.referenced) {frame.referenced = false; continue;}
+			if (frame.dirty) write_frame(frame);
+			page_table.erase(frame.page_id);
+			frame.used = false;
+			return index;
+		}
+		throw std::runtime_error("LinearHashFile: every buffer pool page is pinned");
+	}
+
+public:
+	LinearHashBufferPool(std::fstream& file, uint32_t page_size, size_t pages, LinearHashFileIOStats& io,
+						 LinearHashFileOp& current):
+		file(file), page_size(page_size), frames(pages < 4 ? 4 : pages), io(io), current(current) {
+		for (Frame& frame : frames) frame.data.reset(new char[page_size]);
+	}
+
+	// Fija la página en memoria y devuelve sus bytes. fresh = página nueva: no se lee
+	// del disco, se entrega en cero.
+	char* pin(uint64_t page_id, bool fresh = false) {
+		auto found = page_table.find(page_id);
+		if (found != page_table.end()) {
+			Frame& frame = frames[found->second];
+			++frame.pins; frame.referenced = true;
+			if (fresh) {std::memset(frame.data.get(), 0, page_size); frame.dirty = true;}
+			else ++io.hits[int(current)];
+			return frame.data.get();
+		}
+		size_t index = victim();
+		Frame& frame = frames[index];
+		if (fresh) {
+			std::memset(frame.data.get(), 0, page_size);
+		} else {
+			file.seekg(std::streamoff(page_id * page_size));
+			file.read(frame.data.get(), page_size);
+			if (!file) throw std::runtime_error("LinearHashFile: page read failed");
+			++io.reads[int(current)];
+		}
+		frame.page_id = page_id; frame.used = true; frame.dirty = fresh;
+		frame.referenced = true; frame.pins = 1;
+		page_table[page_id] = index;
+		return frame.data.get();
+	}
+
+	void unpin(uint64_t page_id, bool dirty) {
+		Frame& frame = frames[page_table.at(page_id)];
+		--frame.pins;
+		frame.dirty = frame.dirty || dirty;
+	}
+
+	// Escribe todas las páginas sucias (siguen en memoria)
+	void flush_all() {
+		for (Frame& frame : frames) {
+			if (frame.used && frame.dirty) write_frame(frame);
+		}
+		file.flush();
+	}
+
+	size_t capacity() const {return frames.size();}
+};
+
+template<typename TK, typename TV, typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+class LinearHashFile {
+	struct FileHeader {
+		char magic[8];            // "LHFILE01"
+		uint32_t page_size;
+		uint32_t byte_order;
+		uint64_t M0, i, p, bucketcount, datacount;
+		uint64_t bytes_used;      // suma de los tamaños de todos los registros
+		uint64_t page_count;      // páginas del archivo (incluida la 0)
+		uint64_t free_head;       // primera página libre (0 = ninguna)
+		uint64_t directory_head;  // primera página del directorio (0 = ninguna)
+		uint64_t hash_fingerprint;
+	};
+	// Cabecera de cada página. Buckets: count registros que ocupan used bytes, next = overflow.
+	// Directorio: count ids de página, next = siguiente página del directorio.
+	struct PageHeader {
+		uint32_t count;
+		uint32_t used;
+		uint64_t next;
+	};
+	// Registro: hash (8) + largo de clave (4) + largo de valor (4) + clave + valor
+	static constexpr uint32_t record_header = 16;
+	static constexpr char magic[8] = {'L', 'H', 'F', 'I', 'L', 'E', '0', '1'};
+
+	// Registro leído de un bucket (bytes = registro completo, tal como va en la página)
+	struct Record {
+		uint64_t hash;
+		std::string bytes;
+	};
+
+	std::fstream file;
+	FileHeader header;
+	std::vector<uint64_t> directory;   // página primaria de cada bucket
+	LinearHashFileIOStats io;
+	LinearHashFileOp current = LinearHashFileOp::get;
+	std::unique_ptr<LinearHashBufferPool> pool;
+	LinearHashHasher<TK> hasher;
+
+	// Fija la operación a la que se cargan las E/S mientras dura (se puede anidar)
+	struct OpScope {
+		LinearHashFile& table;
+		LinearHashFileOp previous;
+		OpScope(LinearHashFile& table, LinearHashFileOp op): table(table), previous(table.current) {
+			table.current = op;
+			++table.io.ops[int(op)];
+		}
+		~OpScope() {table.current = previous;}
+	};
+
+	uint32_t payload() const {return header.page_size - uint32_t(sizeof(PageHeader));}
+	static PageHeader& page_header(char* page) {return *reinterpret_cast<PageHeader*>(page);}
+	static char* records_of(char* page) {return page + sizeof(PageHeader);}
+	static uint64_t read_u64(const char* at) {uint64_t v; std::memcpy(&v, at, 8); return v;}
+	static uint32_t read_u32(const char* at) {uint32_t v; std::memcpy(&v, at, 4); return v;}
+	static uint32_t record_size(const char* record) {return record_header + read_u32(record + 8) + read_u32(record + 12);}
+
+	double fillFactor() const {return double(header.bytes_used) / (double(header.bucketcount) * payload());}
+
+	size_t hash_index(uint64_t h) const {
+		uint64_t L = header.M0 << header.i;
+		uint64_t currindex = h % L;
+		if (currindex < header.p) return size_t(h % (2 * L));
+		return size_t(currindex);
+	}
+
+	uint64_t hash_fingerprint() {
+		if constexpr (std::is_constructible_v<TK, const char*>) return uint64_t(hasher(TK("linearhash-snapshot")));
+		else if constexpr (std::is_default_constructible_v<TK>) return uint64_t(hasher(TK{}));
+		else return 0;
+	}
+
+	template<typename T, typename Ser>
+	static std::string serialize(const T& value) {
+		std::string out;
+		Ser::write(out, value);
+		return out;
+	}
+	static std::string encode(uint64_t h, const std::string& key_bytes, const std::string& value_bytes) {
+		std::string record(record_header, '\0');
+		uint32_t klen = uint32_t(key_bytes.size()), vlen = uint32_t(value_bytes.size());
+		std::memcpy(&record[0], &h, 8);
+		std::memcpy(&record[8], &klen, 4);
+		std::memcpy(&record[12], &vlen, 4);
+		record += key_bytes;
+		record += value_bytes;
+		return record;
+	}
+	static bool same_key(const char* record, uint64_t h, const std::string& key_bytes) {
+		return read_u64(record) == h && read_u32(record + 8) == key_bytes.size() &&
+			std::memcmp(record + record_header, key_bytes.data(), key_bytes.size()) == 0;
+	}
+
+	// Páginas nuevas: primero de la free list, si no al final del archivo
+	uint64_t allocate_page() {
+		uint64_t id;
+		if (header.free_head != 0) {
+			id = header.free_head;
+			char* page = pool->pin(id);
+			header.free_head = page_header(page).next;
+			pool->unpin(id, false);
+		} else id = header.page_count++;
+		pool->pin(id, true);
+		pool->unpin(id, true);
+		return id;
+	}
+	void free_page(uint64_t id) {
+		char* page = pool->pin(id, true);
+		page_header(page).next = header.free_head;
+		pool->unpin(id, true);
+		header.free_head = id;
+	}
+
+	// Todos los registros del bucket b (copiados: la cadena se puede reescribir después)
+	std::vector<Record> read_bucket(size_t b) {
+		std::vector<Record> records;
+		for (uint64_t id = directory[b]; id != 0;) {
+			char* page = pool->pin(id);
+			PageHeader& ph = page_header(page);
+			const char* at = records_of(page);
+			for (uint32_t r = 0; r < ph.count; ++r) {
+				uint32_t size = record_size(at);
+				records.push_back({read_u64(at), std::string(at, size)});
+				at += size;
+			}
+			uint64_t next = ph.next;
+			pool->unpin(id, false);
+			id = next;
+		}
+		return records;
+	}
+
+	// Reescribe la cadena del bucket b con "records": reutiliza sus páginas en orden,
+	// pide overflow si hace falta y libera las páginas que sobran
+	void write_bucket(size_t b, const std::vector<Record>& records) {
+		uint64_t id = directory[b];
+		char* page = pool->pin(id);
+		uint64_t rest = page_header(page).next;
+		page_header(page) = PageHeader{0, 0, 0};
+		for (const Record& record : records) {
+			if (page_header(page).used + record.bytes.size() > payload()) {
+				uint64_t next;
+				if (rest != 0) {
+					next = rest;
+					char* reused = pool->pin(rest);
+					rest = page_header(reused).next;
+					pool->unpin(next, false);
+				} else next = allocate_page();
+				page_header(page).next = next;
+				pool->unpin(id, true);
+				id = next;
+				page = pool->pin(id);
+				page_header(page) = PageHeader{0, 0, 0};
+			}
+			PageHeader& ph = page_header(page);
+			std::memcpy(records_of(page) + ph.used, record.bytes.data(), record.bytes.size());
+			ph.used += uint32_t(record.bytes.size());
+			++ph.count;
+		}
+		pool->unpin(id, true);
+		while (rest != 0) {
+			char* extra = pool->pin(rest);
+			uint64_t next = page_header(extra).next;
+			pool->unpin(rest, false);
+			free_page(rest);
+			rest = next;
+		}
+	}
+
+	// Directorio en disco: ids de páginas primarias en una cadena de páginas propia
+	void write_directory() {
+		size_t per_page = payload() / sizeof(uint64_t);
+		uint64_t prev = 0;
+		uint64_t id = header.directory_head;
+		for (size_t start = 0; start < directory.size() || start == 0; start += per_page) {
+			if (id == 0) {
+				id = allocate_page();
+				if (prev == 0) header.directory_head = id;
+				else {char* page = pool->pin(prev); page_header(page).next = id; pool->unpin(prev, true);}
+			}
+			char* page = pool->pin(id);
+			uint64_t next = page_header(page).next;
+			size_t count = std::min(per_page, directory.size() - start);
+			page_header(page).count = uint32_t(count);
+			page_header(page).used = uint32_t(count * sizeof(uint64_t));
+			std::memcpy(records_of(page), directory.data() + start, count * sizeof(uint64_t));
+			if (start + per_page >= directory.size()) page_header(page).next = 0;
+			pool->unpin(id, true);
+			prev = id;
+			id = next;
+			if (start + per_page >= directory.size()) break;
+		}
+		// Páginas del directorio que sobran (después de merges)
+		while (id != 0) {
+			char* page = pool->pin(id);
+			uint64_t next = page_header(page).next;
+			pool->unpin(id, false);
+			free_page(id);
+			id = next;
+		}
+	}
+	void read_directory() {
+		directory.clear();
+		for (uint64_t id = header.directory_head; id != 0;) {
+			char* page = pool->pin(id);
+			size_t count = page_header(page).count;
+			size_t old = directory.size();
+			directory.resize(old + count);
+			std::memcpy(directory.data() + old, records_of(page), count * sizeof(uint64_t));
+			uint64_t next = page_header(page).next;
+			pool->unpin(id, false);
+			id = next;
+		}
+		if (directory.size() != header.bucketcount) throw std::runtime_error("LinearHashFile: corrupt directory");
+	}
+
+	void write_header() {
+		char* page = pool->pin(0, true);
+		std::memcpy(page, &header, sizeof(header));
+		pool->unpin(0, true);
+	}
+
+public:
+	// Abre "path" si existe (page_size y M0 salen del archivo) o lo crea vacío.
+	// pool_pages: páginas que se mantienen en memoria como máximo.
+	LinearHashFile(const std::string& path, size_t pool_pages = 256, uint32_t page_size = 4096, int M0 = 4) {
+		bool exists = std::filesystem::exists(path);
+		if (!exists) std::ofstream(path, std::ios::binary);
+		file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+		if (!file) throw std::runtime_error("LinearHashFile: cannot open " + path);
+		if (exists) {
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			if (!file || std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+				header.byte_order != linearhash_snapshot_byte_order)
+				throw std::runtime_error("LinearHashFile: " + path + " is not a linear hash file");
+			pool = std::make_unique<LinearHashBufferPool>(file, header.page_size, pool_pages, io, current);
+			if (header.hash_fingerprint != hash_fingerprint())
+				throw std::runtime_error("LinearHashFile: " + path + " was written with a different hasher");
+			read_directory();
+			return;
+		}
+		if (page_size < sizeof(FileHeader) || page_size < 256) throw std::invalid_argument("LinearHashFile: page_size too small");
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, magic, sizeof(magic));
+		header.page_size = page_size;
+		header.byte_order = linearhash_snapshot_byte_order;
+		header.M0 = uint64_t(M0); header.bucketcount = uint64_t(M0);
+		header.page_count = 1;
+		header.hash_fingerprint = hash_fingerprint();
+		pool = std::make_unique<LinearHashBufferPool>(file, page_size, pool_pages, io, current);
+		for (int b = 0; b < M0; ++b) directory.push_back(allocate_page());
+		flush();
+	}
+	LinearHashFile(const LinearHashFile&) = delete;
+	LinearHashFile& operator=(const LinearHashFile&) = delete;
+
+	int size() const {return int(header.datacount);}
+	int bucket_count() const {return int(header.bucketcount);}
+	uint64_t page_count() const {return header.page_count;}
+	const LinearHashFileIOStats& io_stats() const {return io;}
+
+	// Inserta o actualiza
+	void insert(const TK& key, const TV& value) {
+		OpScope scope(*this, LinearHashFileOp::insert);
+		std::string key_bytes = serialize<TK, KeySer>(key);
+		std::string record = encode(hasher(key), key_bytes, serialize<TV, ValueSer>(value));
+		if (record.size() > payload()) throw std::invalid_argument("LinearHashFile: record larger than a page");
+		uint64_t h = read_u64(record.data());
+		size_t b = hash_index(h);
+		uint64_t last = 0;
+		for (uint64_t id = directory[b]; id != 0;) {
+			char* page = pool->pin(id);
+			PageHeader& ph = page_header(page);
+			char* at = records_of(page);
+			for (uint32_t r = 0; r < ph.count; ++r) {
+				uint32_t size = record_size(at);
+				if (same_key(at, h, key_bytes)) {
+					if (size == record.size()) {
+						// Mismo tamaño: se pisa en el lugar
+						std::memcpy(at, record.data(), size);
+						pool->unpin(id, true);
+						return;
+					}
+					pool->unpin(id, false);
+					// Otro tamaño: se reescribe el bucket con el registro nuevo
+					std::vector<Record> records = read_bucket(b);
+					for (Record& existing : records) {
+						if (same_key(existing.bytes.data(), h, key_bytes)) existing.bytes = record;
+					}
+					write_bucket(b, records);
+					header.bytes_used += record.size();
+					header.bytes_used -= size;
+					if (fillFactor() > maxFillFactor) split();
+					return;
+				}
+				at += size;
+			}
+			uint64_t next = ph.next;
+			pool->unpin(id, false);
+			last = id;
+			id = next;
+		}
+		// Clave nueva: al final de la última página, o en una página de overflow nueva
+		char* page = pool->pin(last);
+		if (page_header(page).used + record.size() > payload()) {
+			uint64_t overflow = allocate_page();
+			page_header(page).next = overflow;
+			pool->unpin(last, true);
+			last = overflow;
+			page = pool->pin(last);
+		}
+		PageHeader& ph = page_header(page);
+		std::memcpy(records_of(page) + ph.used, record.data(), record.size());
+		ph.used += uint32_t(record.size());
+		++ph.count;
+		pool->unpin(last, true);
+		++header.datacount;
+		header.bytes_used += record.size();
+		if (fillFactor() > maxFillFactor) split();
+	}
+
+	bool try_get(const TK& key, TV& out_value) {
+		OpScope scope(*this, LinearHashFileOp::get);
+		std::string key_bytes = serialize<TK, KeySer>(key);
+		uint64_t h = hasher(key);
+		for (uint64_t id = directory[hash_index(h)]; id != 0;) {
+			char* page = pool->pin(id);
+			PageHeader& ph = page_header(page);
+			const char* at = records_of(page);
+			for (uint32_t r = 0; r < ph.count; ++r) {
+				if (same_key(at, h, key_bytes)) {
+					const char* value = at + record_header + read_u32(at + 8);
+					try {
+						ValueSer::read(value, value + read_u32(at + 12), out_value);
+					} catch (...) {pool->unpin(id, false); throw;}
+					pool->unpin(id, false);
+					return true;
+				}
+				at += record_size(at);
+			}
+			uint64_t next = ph.next;
+			pool->unpin(id, false);
+			id = next;
+		}
+		return false;
+	}
+
+	bool contains(const TK& key) {
+		TV value;
+		return try_get(key, value);
+	}
+
+	bool remove(const TK& key) {
+		OpScope scope(*this, LinearHashFileOp::remove);
+		std::string key_bytes = serialize<TK, KeySer>(key);
+		uint64_t h = hasher(key);
+		size_t b = hash_index(h);
+		uint64_t prev = 0;
+		for (uint64_t id = directory[b]; id != 0;) {
+			char* page = pool->pin(id);
+			PageHeader& ph = page_header(page);
+			char* at = records_of(page);
+			for (uint32_t r = 0; r < ph.count; ++r) {
+				uint32_t size = record_size(at);
+				if (same_key(at, h, key_bytes)) {
+					// Se compacta la página corriendo los registros siguientes
+					char* end = records_of(page) + ph.used;
+					std::memmove(at, at + size, size_t(end - (at + size)));
+					ph.used -= size;
+					--ph.count;
+					uint64_t next = ph.next;
+					bool empty_overflow = ph.count == 0 && prev != 0;
+					pool->unpin(id, true);
+					if (empty_overflow) {
+						// Página de overflow vacía: se desengancha de la cadena y se libera
+						char* before = pool->pin(prev);
+						page_header(before).next = next;
+						pool->unpin(prev, true);
+						free_page(id);
+					}
+					--header.datacount;
+					header.bytes_used -= size;
+					if (fillFactor() < lowerBound && header.bucketcount > header.M0) merge();
+					return true;
+				}
+				at += size;
+			}
+			uint64_t next = ph.next;
+			pool->unpin(id, false);
+			prev = id;
+			id = next;
+		}
+		return false;
+	}
+
+	// Escribe directorio, cabecera y todas las páginas sucias
+	void flush() {
+		OpScope scope(*this, LinearHashFileOp::flush);
+		write_directory();
+		write_header();
+		pool->flush_all();
+	}
+
+	void debug_print(const char* label = "") {
+		cout << "\n========== ESTADO LinearHashFile " << label << " ==========\n";
+		cout << "M0=" << header.M0
+			 << "  i=" << header.i
+			 << "  p=" << header.p
+			 << "  bucketcount=" << header.bucketcount
+			 << "  datacount=" << header.datacount
+			 << "  pages=" << header.page_count
+			 << "  pool=" << pool->capacity()
+			 << "  fillFactor=" << fillFactor()
+			 << "\n";
+		io.print(cout);
+		cout << "===========================================\n";
+	}
+
+	~LinearHashFile() {
+		try {flush();} catch (...) {}
+	}
+
+private:
+	// Divide el bucket p: sus registros se reparten entre p y el bucket nuevo p + L
+	void split() {
+		OpScope scope(*this, LinearHashFileOp::split);
+		uint64_t L = header.M0 << header.i;
+		size_t newindex = size_t(header.p + L);
+		directory.push_back(allocate_page());
+		std::vector<Record> stay, move;
+		for (Record& record : read_bucket(size_t(header.p))) {
+			if (record.hash % (2 * L) == header.p) stay.push_back(std::move(record));
+			else move.push_back(std::move(record));
+		}
+		write_bucket(size_t(header.p), stay);
+		write_bucket(newindex, move);
+		++header.bucketcount;
+		++header.p;
+		if (header.p == L) {++header.i; header.p = 0;}
+	}
+
+	// Junta el último bucket con p - 1 y libera sus páginas
+	void merge() {
+		OpScope scope(*this, LinearHashFileOp::merge);
+		if (header.p == 0) {--header.i; header.p = (header.M0 << header.i) - 1;}
+		else --header.p;
+		size_t last = size_t(header.bucketcount - 1);
+		std::vector<Record> records = read_bucket(size_t(header.p));
+		for (Record& record : read_bucket(last)) records.push_back(std::move(record));
+		write_bucket(size_t(header.p), records);
+		for (uint64_t id = directory[last]; id != 0;) {
+			char* page = pool->pin(id);
+			uint64_t next = page_header(page).next;
+			pool->unpin(id, false);
+			free_page(id);
+			id = next;
+		}
+		directory.pop_back();
+		--header.bucketcount;
+	}
+};
+
+#endif //LINEARHASHFILE_H
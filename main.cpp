@@ -6,33 +6,169 @@
 #include "httplib.h"
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <chrono>
-#include <random>
 #include <fstream>
 #include <thread>
 #include <mutex>
-#include "linearhash.h"
+#include <shared_mutex>
+#include <sstream>
+#include <filesystem>
+#include "shardedlinearhash.h"
+#include "sessionid.h"
+#include "internpool.h"
+#include "linearhash_index.h"
+#include "linearhash_wal.h"
+#include "timingwheel.h"
 #include "json.hpp"
 
 using json = nlohmann::json;
-// Modelo de sesión que se guarda en el LinearHash
+
+// Correos internados: las sesiones de un mismo usuario comparten un solo string.
+// Cada fila de tablaSesiones tiene una referencia a su correo (la de intern) y la suelta al
+// salir de la tabla (logout, vencimiento, desalojo, clear): un correo sin sesiones vivas
+// deja el pool, así una avalancha de logins con correos nuevos no lo hace crecer para siempre.
+// Quien lee el correo de una sesión que no es suya (copiada con try_get) fija el pool antes
+// (correos.pin()): si otro hilo la borra a la par, el texto sigue valiendo hasta que termina.
+StringInternPool correos;
+
+// Modelo de sesión que se guarda en el LinearHash: solo lo que mira /servicio, 16 bytes
+// dentro del nodo y sin memoria dinámica (copiarla en try_get no reserva nada)
 struct Sesion {
-    std::string correo;
+    uint32_t correo;                                    // id en "correos"
+    std::chrono::system_clock::time_point vence_en;     // creación + duracionSesion
+};
+
+// Datos fríos de la sesión: no hacen falta para validar un token, así que van aparte
+// (tabla datosFrios) y no entran en el snapshot ni en el WAL. Después de un reinicio las
+// sesiones restauradas siguen valiendo pero ya no tienen datos fríos.
+struct SesionFria {
     std::string password;
-    std::chrono::system_clock::time_point creada_en;
 };
 
-// Tabla global de sesiones (usa LinearHash.h)
-LinearHash<std::string, Sesion> tablaSesiones(4);
+size_t linearhash_extra_bytes(const SesionFria& fria) {
+    return linearhash_extra_bytes(fria.password);
+}
+
+// Serializador de Sesion para los snapshots y el WAL (ver linearhash_snapshot.h): el correo
+// como texto (largo uint32 + bytes, igual que un std::string; los ids del pool no sobreviven
+// a un reinicio) y vence_en como ticks desde la época (int64). Al leer se vuelve a internar:
+// la referencia pasa a la fila que recibe la sesión (snapshot o WAL, ver recuperar_wal).
+template<>
+struct LinearHashSerializer<Sesion> {
+    static void write(std::string& out, const Sesion& sesion) {
+        std::string_view correo = correos.view(sesion.correo);
+        LinearHashSerializer<uint32_t>::write(out, uint32_t(correo.size()));
+        out.append(correo);
+        LinearHashSerializer<int64_t>::write(out, int64_t(sesion.vence_en.time_since_epoch().count()));
+    }
+    static const char* read(const char* in, const char* end, Sesion& sesion) {
+        uint32_t largo;
+        int64_t ticks;
+        in = LinearHashSerializer<uint32_t>::read(in, end, largo);
+        linearhash_snapshot_check(size_t(end - in) >= largo, "truncated string");
+        sesion.correo = correos.intern(std::string_view(in, largo));
+        in = LinearHashSerializer<int64_t>::read(in + largo, end, ticks);
+        sesion.vence_en = std::chrono::system_clock::time_point(std::chrono::system_clock::duration(ticks));
+        return in;
+    }
+};
+
+// Archivo de snapshot: se carga al arrancar (si existe) y se reescribe en cada limpieza periódica.
+// El nombre lleva la versión del formato de los registros (v2: claves SessionId; v3: Sesion
+// compacta, correo + vencimiento). Los archivos de una versión anterior no se leen: como una
+// sesión dura duracionSesion, al actualizar solo se pierden las sesiones de los últimos minutos.
+const std::string archivoSnapshot = "sesiones-v3.snap";
+// Write-ahead log: cada login / logout / clear / expiración queda registrado para que un
+// crash no cierre todas las sesiones. Los handlers solo encolan el registro en memoria;
+// un hilo del WAL los escribe por lotes con un fdatasync cada ventanaDurabilidad.
+// Si el proceso cae, se pierde como mucho lo de la última ventana.
+const std::string archivoWal = "sesiones-v3.wal";
+const std::chrono::milliseconds ventanaDurabilidad(10);
+
+// Tabla global de sesiones (usa ShardedLinearHash.h)
+// Los hilos de httplib la usan a la vez: la tabla se reparte en N shards independientes
+// (N se decide al arrancar, según los núcleos), cada uno con su propio mutex y sus propios
+// split/merge, así que no hace falta un mutex global alrededor de la tabla.
+// Estadísticas: compilar con -DSESIONES_STATS (staging) para contar probes, splits y merges;
+// sin la macro (producción) la política no hace nada y no cuesta nada.
+// Clave: SessionId (ver sessionid.h), 16 bytes dentro del nodo; los handlers convierten el
+// token de texto en el borde. Hash: SessionIdHasher, una multiplicación (ver
+// PruebasAnteriores/bench_sessionid.cpp contra las claves string de antes).
+#ifdef SESIONES_STATS
+using PoliticaStats = LinearHashFullStats;
+#else
+using PoliticaStats = LinearHashNoStats;
+#endif
+const size_t cantidadShards = std::max(4u, 4 * std::thread::hardware_concurrency());
+ShardedLinearHash<SessionId, Sesion, SessionIdHasher, std::equal_to<>, LinearHashNewDeleteAllocator, PoliticaStats>
+    tablaSesiones(cantidadShards, 4);
 
-std::mutex tablaSesionesMutex;
+// Volcado de la tabla después de cada operación: compilar con -DSESIONES_DEBUG. debug_print
+// toma el lock de todos los shards y recorre la tabla entera, así que sin la macro no se hace
+// (en producción sería O(sesiones) en cada login / logout).
+void depurar_tabla(const char* etiqueta) {
+#ifdef SESIONES_DEBUG
+    tablaSesiones.debug_print(etiqueta);
+#else
+    (void)etiqueta;
+#endif
+}
+// Datos fríos por token. Se borran junto con la sesión (logout, vencimiento, desalojo, clear).
+// En un alta se escriben ANTES que tablaSesiones: si el presupuesto desaloja la sesión apenas
+// entra, el callback de desalojo ya encuentra sus datos fríos y los borra (al revés, el
+// password quedaría huérfano para siempre). En una baja se borran después de la tabla.
+ShardedLinearHash<SessionId, SesionFria, SessionIdHasher> datosFrios(cantidadShards, 4);
+// Índice correo -> tokens de sus sesiones activas (ordenados del más viejo al más nuevo), para
+// /logout-all, /admin/sessions y el tope por usuario sin recorrer toda la tabla. No se persiste:
+// al arrancar se arma con la tabla. Cada alta y baja lo actualiza desde adentro del callback
+// de tablaSesiones (upsert / remove_if / desalojo), con el lock del shard del token tomado:
+// nadie ve ni desaloja la fila sin que su token ya esté en el índice, así que el índice tiene
+// exactamente los tokens de la tabla. La única excepción es /logout-all, que saca los tokens
+// del índice (take) antes de borrar sus filas.
+LinearHashSecondaryIndex<uint32_t, SessionId, LinearHashIntHasher> sesionesPorCorreo(cantidadShards, 4);
+// Máximo de sesiones activas por usuario (0 = sin límite): al pasarse, un login nuevo cierra
+// las más viejas de ese usuario
+const size_t maxSesionesPorUsuario = 0;
+// Cada alta y baja se encola en el WAL desde adentro del callback de la tabla (upsert /
+// remove_if / desalojo), con el lock del shard tomado: registro y cambio son un solo paso
+// para el checkpoint (ver guardar_snapshot). Orden de locks: shard -> WAL, nunca al revés.
+LinearHashWal<SessionId, Sesion> walSesiones;
+// /admin/clear contra todo lo demás que escribe: clear toma este lock exclusivo alrededor de
+// log_clear y de vaciar tabla, datos fríos e índice; los logins, las bajas (logout, logout-all,
+// vencimientos) y el checkpoint lo toman compartido. Así un login no puede quedar de un lado
+// del clear en la tabla y del otro en el log o en el índice, ni un checkpoint guardar una
+// tabla vaciada a medias. Quien lo toma compartido no lo vuelve a pedir (borrar_sesion no lo
+// toma: lo tiene quien la llama).
+// Carrera que queda: las lecturas (/servicio, /admin/sessions, /admin/stats) no lo toman, así
+// que una lectura a la par de un clear puede ver una sesión que el clear está por borrar (o
+// ya ver vacío un shard y no otro). Es la misma respuesta que si hubiera llegado antes del
+// clear, y nada de lo que leen vuelve a la tabla.
+std::shared_mutex exclusionClear;
+
+// Tope de memoria de la tabla: ante una avalancha de logins tablaSesiones no crece sin
+// límite; al pasarse, cada login desaloja sesiones frías (las que no se usaron en /servicio
+// desde la última vuelta del CLOCK). Las desalojadas se registran en el WAL como un logout.
+// El presupuesto cuenta solo los nodos de la tabla: datos fríos, índice por correo y rueda
+// de vencimientos no entran en él, pero el callback de desalojo saca de ellos a la sesión,
+// así que crecen con las sesiones vivas y no con los logins.
+const LinearHashBudget presupuestoSesiones{2000000, size_t(1) << 30};   // 2M sesiones o 1 GiB
+
+// Vencimiento: una sesión vence exactamente duracionSesion después de creada (en vence_en).
+// La rueda de vencimientos agenda cada token en su instante de vencimiento, así la
+// limpieza (un tick por segundo) toca solo las sesiones que vencieron. Toda baja (logout,
+// desalojo, /admin/clear) cancela su entrada: la rueda guarda solo sesiones vivas.
+const std::chrono::minutes duracionSesion(5);
+TimingWheel<SessionId, 4, SessionIdHasher> vencimientos(std::chrono::seconds(1));
 
-// Generar token único
-std::string generar_token() {
-    auto now = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937_64 rng(std::random_device{}());
-    uint64_t r = rng();
-    return std::to_string(now) + "_" + std::to_string(r);
+void agendar_vencimiento(const SessionId& token, const Sesion& sesion) {
+    vencimientos.schedule(token, sesion.vence_en);
+}
+
+// Generar token único: ticks de ahora + 64 bits del ChaCha20 del hilo (ver tokenrng.h;
+// se siembra una vez por hilo de httplib, el login no toca random_device)
+SessionId generar_token() {
+    return mint_session_id();
 }
 
 void cargar_sesiones_iniciales() {
@@ -59,61 +195,179 @@ void cargar_sesiones_iniciales() {
         {"user19@test.com", "pass19"},
         {"user20@test.com", "pass20"}
     };
-    for (const auto& u : usuarios) {
-        const std::string& correo   = u.first;
-        const std::string& password = u.second;
-        std::string token = generar_token();
-        Sesion sesion{
-            correo,
-            password,
-            std::chrono::system_clock::now()
-        };
-        tablaSesiones.insert(token, sesion);
-        cout << "[BOOT] Sesion inicial insertada -> correo=" << correo
+    // Los tokens de la carga salen de un solo lote
+    std::vector<SessionId> tokens(usuarios.size());
+    mint_session_ids(tokens);
+    for (size_t k = 0; k < usuarios.size(); ++k) {
+        auto& u = usuarios[k];
+        const SessionId& token = tokens[k];
+        cout << "[BOOT] Sesion inicial -> correo=" << u.first
              << "  token=" << token << "\n";
+        // El vector ya no se usa: el password se mueve a los datos fríos (antes que la sesión)
+        datosFrios.try_emplace(token, SesionFria{std::move(u.second)});
+        tablaSesiones.try_emplace(token, Sesion{
+            correos.intern(u.first),
+            std::chrono::system_clock::now() + duracionSesion
+        });
+    }
+    depurar_tabla("DESPUES DE CARGA INICIAL (20 sesiones)");
+}
+
+// Borra una sesión de la tabla, de los datos fríos, del índice por correo y de la rueda de
+// vencimientos (y la registra en el WAL); false si el token no existía. Solo se registra lo que de verdad se borró, y desde
+// adentro de remove_if: un /logout con un token bien formado pero desconocido no escribe nada.
+// Quien la llama tiene tomado exclusionClear (compartido).
+bool borrar_sesion(const SessionId& token) {
+    bool borrada = tablaSesiones.remove_if(token, [&token](const Sesion& sesion) {
+        walSesiones.log_remove(token);
+        sesionesPorCorreo.remove(sesion.correo, token);
+        correos.release(sesion.correo);
+        return true;
+    });
+    if (!borrada) return false;
+    datosFrios.remove(token);
+    vencimientos.cancel(token);
+    return true;
+}
+
+// Suelta la referencia al correo de cada sesión, antes de vaciar la tabla con clear
+void soltar_correos() {
+    tablaSesiones.for_each([](const SessionId&, const Sesion& sesion) {correos.release(sesion.correo);});
+}
+
+// Restaura las sesiones del último snapshot; devuelve false si no hay snapshot usable
+bool cargar_snapshot() {
+    if (!std::filesystem::exists(archivoSnapshot)) return false;
+    try {
+        auto t0 = std::chrono::steady_clock::now();
+        tablaSesiones.load_snapshot(archivoSnapshot);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+        cout << "[BOOT] Snapshot " << archivoSnapshot << " cargado: " << tablaSesiones.size()
+             << " sesiones en " << ms << " ms\n";
+        return true;
+    } catch (const std::exception& e) {
+        cout << "[BOOT][ERROR] No se pudo cargar " << archivoSnapshot << ": " << e.what() << "\n";
+        return false;
+    }
+}
+
+// Aplica el WAL (en paralelo) sobre lo que dejó el snapshot: primero el log rotado de un
+// checkpoint que no llegó a terminar, si quedó, y después el log actual
+void recuperar_wal() {
+    for (const std::string& archivo : {archivoWal + ".old", archivoWal}) {
+        try {
+            auto t0 = std::chrono::steady_clock::now();
+            size_t registros = LinearHashWal<SessionId, Sesion>::replay(archivo, 0,
+                [](SessionId&& token, Sesion&& sesion) {
+                    // Un token repetido reemplaza la fila: se suelta el correo de la anterior
+                    if (tablaSesiones.try_emplace(token, sesion)) return;
+                    tablaSesiones.update(token, [&sesion](Sesion& fila) {
+                        correos.release(fila.correo);
+                        fila = sesion;
+                        return true;
+                    });
+                },
+                [](const SessionId& token) {
+                    tablaSesiones.remove_if(token, [](const Sesion& sesion) {
+                        correos.release(sesion.correo);
+                        return true;
+                    });
+                },
+                [] {soltar_correos(); tablaSesiones.clear();});
+            if (registros == 0) continue;
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+            cout << "[BOOT] WAL " << archivo << ": " << registros << " registros aplicados en " << ms
+                 << " ms (" << tablaSesiones.size() << " sesiones)\n";
+        } catch (const std::exception& e) {
+            cout << "[BOOT][ERROR] No se pudo aplicar " << archivo << ": " << e.what() << "\n";
+        }
+    }
+}
+
+// Checkpoint: se rota el WAL, se guarda el snapshot y recién entonces se borra el log viejo
+// (si el snapshot falla, el log viejo queda y se vuelve a aplicar al arrancar).
+// Borrar el log viejo es seguro porque cada registro se encola con el lock de su shard: si
+// quedó en el log viejo (antes de rotate), su cambio ya estaba hecho cuando save_snapshot
+// tomó ese shard; si no, quedó en el log nuevo y se vuelve a aplicar.
+void guardar_snapshot() {
+    std::shared_lock<std::shared_mutex> lock(exclusionClear);
+    try {
+        walSesiones.rotate();
+        tablaSesiones.save_snapshot(archivoSnapshot);
+        walSesiones.remove_rotated();
+        cout << "[SNAPSHOT] " << tablaSesiones.size() << " sesiones guardadas en " << archivoSnapshot
+             << " (WAL: " << walSesiones.record_count() << " registros en " << walSesiones.batch_count() << " lotes)\n";
+    } catch (const std::exception& e) {
+        cout << "[SNAPSHOT][ERROR] " << e.what() << "\n";
     }
-    tablaSesiones.debug_print("DESPUES DE CARGA INICIAL (20 sesiones)");
 }
 
+// Borra las sesiones que vencieron desde el último tick (las entrega la rueda, sin recorrer la tabla).
+// Las bajas cancelan su vencimiento, pero remove_if igual confirma contra la tabla: si el
+// token ya no está o todavía no venció, no borra nada.
 void limpiar_sesiones_expiradas() {
-    std::lock_guard<std::mutex> lock(tablaSesionesMutex);
     auto ahora = std::chrono::system_clock::now();
-    
-    cout << "[CLEANUP] Recorriendo tabla para buscar sesiones expiradas (>5 minutos)...\n";
-    
-    int eliminados = tablaSesiones.for_each_remove_if([&ahora](const std::string& token, Sesion& sesion) -> bool {
-        auto diff_min = std::chrono::duration_cast<std::chrono::minutes>(ahora - sesion.creada_en).count();
-        if (diff_min > 5) {
-            cout << "[CLEANUP] Token expirado: " << token << " (expirado hace " << diff_min - 5 << " minutos)\n";
+    int eliminadas = 0;
+    std::shared_lock<std::shared_mutex> lock(exclusionClear);
+    for (const SessionId& token : vencimientos.advance(ahora)) {
+        bool vencida = tablaSesiones.remove_if(token, [&ahora, &token](const Sesion& sesion) {
+            if (ahora < sesion.vence_en) return false;
+            walSesiones.log_remove(token);
+            sesionesPorCorreo.remove(sesion.correo, token);
+            correos.release(sesion.correo);
             return true;
-        }
-        return false;
-    });
-    
-    if (eliminados > 0) {
-        cout << "[CLEANUP] Se eliminaron " << eliminados << " sesiones expiradas\n";
-        tablaSesiones.debug_print("DESPUES DE LIMPIEZA AUTOMATICA");
-    } else {
-        cout << "[CLEANUP] No se encontraron sesiones expiradas\n";
+        });
+        if (!vencida) continue;
+        datosFrios.remove(token);
+        ++eliminadas;
+        cout << "[CLEANUP] Token expirado: " << token << "\n";
+    }
+    if (eliminadas > 0) {
+        cout << "[CLEANUP] Se eliminaron " << eliminadas << " sesiones expiradas ("
+             << vencimientos.size() << " vencimientos agendados)\n";
+        depurar_tabla("DESPUES DE LIMPIEZA AUTOMATICA");
     }
 }
 
 void hilo_limpieza_periodica() {
-    const int intervalo_limpieza_segundos = 300;
+    const int intervalo_snapshot_segundos = 300;
     
     cout << "\n[CLEANUP] Hilo de limpieza automática INICIADO\n";
-    cout << "[CLEANUP] Se ejecutará cada 5 minutos\n\n";
+    cout << "[CLEANUP] Vence sesiones cada segundo y guarda snapshot cada 5 minutos\n\n";
     
+    auto proximo_snapshot = std::chrono::steady_clock::now() + std::chrono::seconds(intervalo_snapshot_segundos);
     while (true) {
-        std::this_thread::sleep_for(std::chrono::seconds(intervalo_limpieza_segundos));
-        cout << "[CLEANUP] Ejecutando limpieza automática...\n";
+        std::this_thread::sleep_for(vencimientos.tick());
         limpiar_sesiones_expiradas();
+        if (std::chrono::steady_clock::now() >= proximo_snapshot) {
+            guardar_snapshot();
+            proximo_snapshot += std::chrono::seconds(intervalo_snapshot_segundos);
+        }
     }
 }
 
 int main() {
     httplib::Server svr;
-    cargar_sesiones_iniciales();
+    if (!cargar_snapshot()) cargar_sesiones_iniciales();
+    recuperar_wal();
+    walSesiones.open(archivoWal, ventanaDurabilidad);
+    tablaSesiones.set_budget(presupuestoSesiones, [](const SessionId& token, const Sesion& sesion) {
+        walSesiones.log_remove(token);
+        datosFrios.remove(token);
+        sesionesPorCorreo.remove(sesion.correo, token);
+        vencimientos.cancel(token);
+        correos.release(sesion.correo);
+    });
+    // Sin tope: solo para que datosFrios lleve la cuenta de bytes (ver /admin/stats)
+    datosFrios.set_budget({0, ~size_t(0)});
+    // Lo recuperado pasa al snapshot y el WAL arranca vacío
+    guardar_snapshot();
+    // Cada sesión restaurada (o inicial) entra en la rueda de vencimientos (las ya vencidas caen
+    // en el primer tick) y en el índice por correo
+    tablaSesiones.for_each([](const SessionId& token, const Sesion& sesion) {
+        agendar_vencimiento(token, sesion);
+        sesionesPorCorreo.add(sesion.correo, token);
+    });
 
     svr.set_default_headers({{"Access-Control-Allow-Origin", "*"},
                              {"Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS"},
@@ -167,20 +421,39 @@ int main() {
     svr.Post("/login", [](const httplib::Request& req, httplib::Response& res) {
         try {
             auto body = json::parse(req.body);
-            std::string correo   = body.at("correo").get<std::string>();
-            std::string password = body.at("password").get<std::string>();
-            std::string token = generar_token();
-            Sesion sesion {
-                correo,
-                password,
-                std::chrono::system_clock::now()
-            };
+            // El correo se interna directo desde el JSON parseado; el password se mueve (no se copia)
+            const std::string& correo = body.at("correo").get_ref<const std::string&>();
+            std::string password = std::move(body.at("password").get_ref<std::string&>());
+            SessionId token = generar_token();
             cout << "[LOGIN] correo=" << correo << " password=" << password << "\n";
             cout << "[LOGIN] token generado=" << token << "\n";
-            tablaSesiones.insert(token, sesion);
-            tablaSesiones.debug_print("DESPUES DE /login (insert)");
+            Sesion sesion{
+                correos.intern(correo),
+                std::chrono::system_clock::now() + duracionSesion
+            };
+            std::shared_lock<std::shared_mutex> lock(exclusionClear);
+            // Agendada bajo exclusionClear (un clear a la par no la deja sin vencimiento) y antes
+            // de la fila: una baja que llegue apenas entra ya encuentra qué cancelar
+            agendar_vencimiento(token, sesion);
+            // Los datos fríos antes que la sesión (ver datosFrios)
+            datosFrios.try_emplace(token, SesionFria{std::move(password)});
+            // La fila, su registro en el WAL y su token en el índice entran bajo el mismo lock
+            // (ver walSesiones y sesionesPorCorreo); el WAL solo encola, el login no espera al
+            // disco. Con tope por usuario, el índice devuelve las sesiones más viejas que
+            // sobran; se cierran afuera del callback (borrar_sesion vuelve a entrar a la tabla)
+            std::vector<SessionId> sobrantes = tablaSesiones.upsert(token, [&](Sesion& nueva) {
+                walSesiones.log_insert(token, sesion);
+                nueva = sesion;
+                return sesionesPorCorreo.add(sesion.correo, token, maxSesionesPorUsuario);
+            });
+            for (const SessionId& vieja : sobrantes) {
+                if (borrar_sesion(vieja)) cout << "[LOGIN] tope por usuario: se cerro la sesion " << vieja << "\n";
+            }
+            lock.unlock();
+            depurar_tabla("DESPUES DE /login (insert)");
+            // El token pasa a texto solo para la respuesta
             json resp;
-            resp["token"] = token;
+            resp["token"] = to_string(token);
             res.set_content(resp.dump(), "application/json");
             res.status = 200;
         }
@@ -200,12 +473,14 @@ int main() {
     // - Si existe pero token ya paso > 1 hora -> se borra y 401 "sesión terminada"
     // - Si tod0 OK -> 200 "acceso permitido"
     svr.Get("/servicio", [](const httplib::Request& req, httplib::Response& res) {
-        std::string token;
-        if (req.has_param("token")) {
-            token = req.get_param_value("token");
+        // El token se lee directo del parámetro ya parseado por httplib (sin copiarlo)
+        std::string_view texto;
+        auto param = req.params.find("token");
+        if (param != req.params.end()) {
+            texto = param->second;
         }
-        cout << "[SERVICIO] llamado con token=" << token << "\n";
-        if (token.empty()) {
+        cout << "[SERVICIO] llamado con token=" << texto << "\n";
+        if (texto.empty()) {
             json err;
             err["mensaje"] = "Token requerido";
             res.set_content(err.dump(), "application/json");
@@ -213,37 +488,46 @@ int main() {
             cout << "[SERVICIO][ERROR] token vacio\n";
             return;
         }
+        // Un texto que no es un SessionId no puede estar en la tabla: mismo 401 que un token desconocido.
+        // El pool se fija antes de leer la sesión: su correo vale aunque un logout la borre a la par
+        SessionId token;
         Sesion sesion;
-        if (!tablaSesiones.try_get(token, sesion)) {
+        auto lectura = correos.pin();
+        if (!parse_session_id(texto, token) || !tablaSesiones.try_get(token, sesion)) {
             json err;
             err["mensaje"] = "Token invalido o no encontrado";
             res.set_content(err.dump(), "application/json");
             res.status = 401;
             cout << "[SERVICIO][ERROR] token no encontrado en tabla\n";
-            tablaSesiones.debug_print("SERVICIO - token no encontrado");
+            depurar_tabla("SERVICIO - token no encontrado");
             return;
         }
         auto ahora = std::chrono::system_clock::now();
         auto diff_min =
-            std::chrono::duration_cast<std::chrono::minutes>(ahora - sesion.creada_en)
+            std::chrono::duration_cast<std::chrono::minutes>(ahora - (sesion.vence_en - duracionSesion))
                 .count();
         cout << "[SERVICIO] token encontrado. Minutos desde creación=" << diff_min << "\n";
-        if (diff_min > 5) {
+        // Puede llegar antes que el tick de limpieza: se vence igual, en el instante exacto
+        if (ahora >= sesion.vence_en) {
             cout << "[SERVICIO] token EXPIRADO, se eliminara de la tabla\n";
-            tablaSesiones.remove(token);
-            tablaSesiones.debug_print("DESPUES DE eliminar token EXPIRADO en /servicio");
+            {
+                std::shared_lock<std::shared_mutex> lock(exclusionClear);
+                borrar_sesion(token);
+            }
+            depurar_tabla("DESPUES DE eliminar token EXPIRADO en /servicio");
             json resp;
             resp["mensaje"] = "Sesion terminada, vuelva a loguearse";
             res.set_content(resp.dump(), "application/json");
             res.status = 401;
             return;
         }
+        std::string_view correo = correos.view(sesion.correo);
         json ok;
         ok["mensaje"] = "Acceso permitido";
-        ok["correo"]  = sesion.correo;
+        ok["correo"]  = correo;
         res.set_content(ok.dump(), "application/json");
         res.status = 200;
-        cout << "[SERVICIO] acceso permitido para correo=" << sesion.correo << "\n";
+        cout << "[SERVICIO] acceso permitido para correo=" << correo << "\n";
     });
 
     // 3. LOGOUT
@@ -253,10 +537,15 @@ int main() {
     svr.Post("/logout", [](const httplib::Request& req, httplib::Response& res) {
         try {
             auto body = json::parse(req.body);
-            std::string token = body.at("token").get<std::string>();
-            cout << "[LOGOUT] token=" << token << "\n";
-            bool eliminado = tablaSesiones.remove(token);
-            tablaSesiones.debug_print("DESPUES DE /logout (remove)");
+            const std::string& texto = body.at("token").get_ref<const std::string&>();
+            cout << "[LOGOUT] token=" << texto << "\n";
+            SessionId token;
+            bool eliminado = false;
+            if (parse_session_id(texto, token)) {
+                std::shared_lock<std::shared_mutex> lock(exclusionClear);
+                eliminado = borrar_sesion(token);
+            }
+            depurar_tabla("DESPUES DE /logout (remove)");
             json resp;
             if (eliminado) {
                 resp["mensaje"] = "Sesion cerrada correctamente";
@@ -283,16 +572,135 @@ int main() {
     // Sin body. Borra TODAS las sesiones.
     svr.Post("/admin/clear", [](const httplib::Request& req, httplib::Response& res) {
         (void)req; cout << "[ADMIN/CLEAR] se eliminaran TODAS las sesiones\n";
-        tablaSesiones.clear();
-        tablaSesiones.debug_print("DESPUES DE /admin/clear (clear)");
+        {
+            std::unique_lock<std::shared_mutex> lock(exclusionClear);
+            walSesiones.log_clear();
+            soltar_correos();
+            tablaSesiones.clear();
+            datosFrios.clear();
+            sesionesPorCorreo.clear();
+            vencimientos.clear();
+        }
+        depurar_tabla("DESPUES DE /admin/clear (clear)");
         json resp;
         resp["mensaje"] = "Todas las sesiones han sido eliminadas";
         res.set_content(resp.dump(), "application/json");
         res.status = 200;
     });
 
+    // 5. SNAPSHOT (ADMIN)
+    // POST /admin/snapshot
+    // Sin body. Guarda ya mismo todas las sesiones en el archivo de snapshot.
+    svr.Post("/admin/snapshot", [](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        guardar_snapshot();
+        json resp;
+        resp["mensaje"] = "Snapshot guardado";
+        resp["sesiones"] = tablaSesiones.size();
+        res.set_content(resp.dump(), "application/json");
+        res.status = 200;
+    });
+
+    // 6. ESTADISTICAS (ADMIN)
+    // GET /admin/stats
+    // Texto con probes por operación, splits/merges y largos de cadena (si se compiló con SESIONES_STATS)
+    svr.Get("/admin/stats", [](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        std::ostringstream out;
+        int sesiones = tablaSesiones.size();
+        size_t bytes = tablaSesiones.memory_bytes(), bytes_frios = datosFrios.memory_bytes(),
+               bytes_correos = correos.memory_bytes();
+        out << "sesiones=" << sesiones << " bytes=" << bytes
+            << " desalojadas=" << tablaSesiones.evicted_count() << " vencimientos=" << vencimientos.size() << "\n";
+        // Bytes por sesión: los de la tabla (nodo) y el total con datos fríos y correos internados
+        out << "bytes_por_sesion=" << (sesiones > 0 ? bytes / sesiones : 0)
+            << " total_por_sesion=" << (sesiones > 0 ? (bytes + bytes_frios + bytes_correos) / sesiones : 0)
+            << " datos_frios=" << bytes_frios << " correos=" << correos.size() << " (" << bytes_correos << " bytes)\n";
+        tablaSesiones.stats_snapshot().print(out);
+        res.set_content(out.str(), "text/plain");
+        res.status = 200;
+    });
+
+    // 7. LOGOUT EN TODOS LADOS
+    // POST /logout-all
+    // Body JSON: { "token": "..." }
+    // Cierra todas las sesiones del usuario dueño del token (incluida esa), vía el índice por correo
+    svr.Post("/logout-all", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            const std::string& texto = body.at("token").get_ref<const std::string&>();
+            cout << "[LOGOUT-ALL] token=" << texto << "\n";
+            SessionId token;
+            Sesion sesion;
+            json resp;
+            auto lectura = correos.pin();   // ver /servicio
+            if (!parse_session_id(texto, token) || !tablaSesiones.try_get(token, sesion)) {
+                resp["mensaje"] = "Token no encontrado";
+                res.set_content(resp.dump(), "application/json");
+                res.status = 404;
+                cout << "[LOGOUT-ALL][WARN] token no existia en la tabla\n";
+                return;
+            }
+            int cerradas = 0;
+            {
+                std::shared_lock<std::shared_mutex> lock(exclusionClear);
+                for (const SessionId& otro : sesionesPorCorreo.take(sesion.correo)) cerradas += borrar_sesion(otro);
+            }
+            depurar_tabla("DESPUES DE /logout-all");
+            resp["mensaje"] = "Se cerraron todas las sesiones del usuario";
+            resp["sesiones_cerradas"] = cerradas;
+            res.set_content(resp.dump(), "application/json");
+            res.status = 200;
+            // El pool sigue fijado: el correo se lee aunque se haya soltado con la última sesión
+            cout << "[LOGOUT-ALL] " << cerradas << " sesiones cerradas para correo=" << correos.view(sesion.correo) << "\n";
+        }
+        catch (...) {
+            json err;
+            err["mensaje"] = "Error en logout-all";
+            res.set_content(err.dump(), "application/json");
+            res.status = 400;
+            cout << "[LOGOUT-ALL][ERROR] excepcion al parsear body\n";
+        }
+    });
+
+    // 8. SESIONES DE UN USUARIO (ADMIN)
+    // GET /admin/sessions?correo=XXXX
+    // Tokens activos del correo (del más viejo al más nuevo) con los segundos que les quedan
+    svr.Get("/admin/sessions", [](const httplib::Request& req, httplib::Response& res) {
+        auto param = req.params.find("correo");
+        if (param == req.params.end() || param->second.empty()) {
+            json err;
+            err["mensaje"] = "Correo requerido";
+            res.set_content(err.dump(), "application/json");
+            res.status = 400;
+            return;
+        }
+        json resp;
+        resp["correo"] = param->second;
+        resp["sesiones"] = json::array();
+        // Un correo sin sesiones vivas no está en el pool (no se agrega por una consulta).
+        // Fijado: el id no se recicla para otro correo mientras se recorren sus sesiones
+        uint32_t correo;
+        auto lectura = correos.pin();
+        if (correos.find(param->second, correo)) {
+            auto ahora = std::chrono::system_clock::now();
+            for (const SessionId& token : sesionesPorCorreo.get(correo)) {
+                Sesion sesion;
+                // Se pudo cerrar entre get y try_get (logout, vencimiento, desalojo)
+                if (!tablaSesiones.try_get(token, sesion)) continue;
+                json item;
+                item["token"] = to_string(token);
+                item["segundos_restantes"] =
+                    std::chrono::duration_cast<std::chrono::seconds>(sesion.vence_en - ahora).count();
+                resp["sesiones"].push_back(std::move(item));
+            }
+        }
+        res.set_content(resp.dump(), "application/json");
+        res.status = 200;
+    });
+
     std::cout << "Servidor escuchando en http://localhost:8080\n";
-    tablaSesiones.debug_print("ESTADO INICIAL (tabla ingestada)");
+    depurar_tabla("ESTADO INICIAL (tabla ingestada)");
     
     std::thread cleanup_thread(hilo_limpieza_periodica);
     cleanup_thread.detach();
@@ -0,0 +1,426 @@
+#ifndef PAGEDLINEARHASH_H
+#define PAGEDLINEARHASH_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "linearhash.h"
+
+// Comparación de tags: AVX2 si el compilador lo habilita (-mavx2), si no SSE2 (siempre en
+// x86-64) y si no byte a byte. -DLINEARHASH_NO_SIMD fuerza la versión escalar (para medirla
+// y verificarla en una máquina con SIMD, ver PruebasAnteriores/bench_paged.cpp).
+#if defined(LINEARHASH_NO_SIMD)
+#define LINEARHASH_TAG_ISA "escalar"
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LINEARHASH_AVX2 1
+#define LINEARHASH_TAG_ISA "avx2"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LINEARHASH_SSE2 1
+#define LINEARHASH_TAG_ISA "sse2"
+#else
+#define LINEARHASH_TAG_ISA "escalar"
+#endif
+
+// Linear Hashing con buckets paginados (esquema original de Litwin).
+// Cada bucket lógico es una página de capacidad fija (PageSlots registros),
+// alineada a línea de caché; solo cuando la página se llena se encadena
+// una página de overflow. Los registros de un bucket se mantienen compactos:
+// todas las páginas de la cadena están llenas salvo la última.
+// Misma API que LinearHash (insert / try_get / remove / contains / clear /
+// debug_print / for_each_remove_if), así que main.cpp puede cambiar de una a otra.
+
+// Fingerprint (tag) de un registro: los 7 bits más altos del hash con el bit 7 encendido.
+// Los bits bajos ya los usa el índice del bucket, así que los altos discriminan mejor
+// dentro de un mismo bucket; el bit 7 hace que un tag nunca valga 0.
+inline uint8_t linearhash_tag(size_t hash) {return uint8_t((uint64_t(hash) >> 57) | 0x80);}
+
+// Compara "tag" contra tags[0..TagBytes) y devuelve una máscara con el bit s encendido
+// si tags[s] == tag. TagBytes es múltiplo de 16: con AVX2 se comparan 32 tags por
+// instrucción, con SSE2 16, y sin SIMD se recorre byte a byte.
+template<int TagBytes>
+inline uint64_t linearhash_match_tags(const uint8_t* tags, uint8_t tag) {
+	static_assert(TagBytes % 16 == 0 && TagBytes <= 64, "TagBytes debe ser 16, 32, 48 o 64");
+	uint64_t mask = 0;
+#if defined(LINEARHASH_AVX2)
+	int b = 0;
+	const __m256i needle32 = _mm256_set1_epi8(char(tag));
+	for (; b + 32 <= TagBytes; b += 32) {
+		__m256i chunk = _mm256_load_si256(reinterpret_cast<const __m256i*>(tags + b));
+		mask |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle32)))) << b;
+	}
+	if (b < TagBytes) {
+		__m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(tags + b));
+		mask |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(char(tag)))))) << b;
+	}
+#elif defined(LINEARHASH_SSE2)
+	const __m128i needle = _mm_set1_epi8(char(tag));
+	for (int b = 0; b < TagBytes; b += 16) {
+		__m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(tags + b));
+		mask |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)))) << b;
+	}
+#else
+	for (int b = 0; b < TagBytes; ++b) mask |= uint64_t(tags[b] == tag) << b;
+#endif
+	return mask;
+}
+
+template<typename TK, typename TV, int PageSlots>
+struct alignas(64) LinearHashPage {
+	// Tags redondeados a múltiplo de 16 (los de más quedan en 0 y nunca coinciden)
+	static constexpr int tag_bytes = (PageSlots + 15) / 16 * 16;
+	// Cabecera: tags, cantidad de registros, página de overflow y los hashes completos.
+	// El sondeo compara primero todos los tags de la página de una vez (una línea de caché);
+	// solo los slots cuyo tag coincide miran el hash completo y la clave.
+	alignas(32) uint8_t tags[tag_bytes];
+	int count;
+	LinearHashPage* overflow;
+	size_t hashes[PageSlots];
+	TK keys[PageSlots];
+	TV values[PageSlots];
+	LinearHashPage(): tags(), count(0), overflow(nullptr) {}
+};
+
+// PageSlots: registros por página. Con 16 los tags de una página se comparan con una
+// sola instrucción SSE2 (con 32, una AVX2).
+template<typename TK, typename TV, int PageSlots = 16>
+class PagedLinearHash {
+	static_assert(PageSlots > 0 && PageSlots <= 64, "PageSlots debe estar entre 1 y 64");
+	typedef LinearHashPage<TK, TV, PageSlots> Page;
+
+	Page** array;        // página primaria de cada bucket físico
+	int* bucket_sizes;   // registros por bucket (sumando overflow)
+	int visited;         // slots/páginas visitados (para estadísticas)
+	int overflowcount;   // páginas de overflow vivas
+	// Mismo significado que en LinearHash
+	int M0, p, i, datacount, bucketcount, capacity;
+
+	double fillFactor() {
+		// Carga relativa a la capacidad en registros de las páginas primarias
+		return double(datacount) / (double(bucketcount) * PageSlots);
+	}
+	LinearHashHasher<TK> hasher;   // mismo hasher transparente que LinearHash
+
+	template<typename K>
+	size_t hash_of(const K& key) {return hasher(key);}
+	size_t hash_index(size_t base_hash) {
+		size_t currindex = base_hash % ((size_t(1) << i) * M0);
+		if (currindex < size_t(p)) return base_hash % ((size_t(1) << (i + 1)) * M0);
+		return currindex;
+	}
+	size_t extended_hash_index(size_t base_hash) {
+		return base_hash % ((size_t(1) << (i + 1)) * M0);
+	}
+
+	// Busca la clave en la cadena del bucket: devuelve página y slot (o nullptr).
+	// Por página: una comparación vectorial de tags y solo después hash + clave de los candidatos
+	// (una búsqueda fallida casi nunca llega a comparar una clave).
+	template<typename K>
+	Page* find_slot(size_t index, size_t h, const K& key, int& slot) {
+		uint8_t tag = linearhash_tag(h);
+		for (Page* page = array[index]; page != nullptr; page = page->overflow) {
+			++visited;
+			uint64_t candidates = linearhash_match_tags<Page::tag_bytes>(page->tags, tag);
+			while (candidates != 0) {
+				int s = std::countr_zero(candidates);
+				candidates &= candidates - 1;
+				if (page->hashes[s] == h && page->keys[s] == key) {slot = s; return page;}
+			}
+		}
+		return nullptr;
+	}
+
+	// Agrega un registro al final de la cadena del bucket (abre overflow si hace falta)
+	void append(size_t index, size_t h, TK&& key, TV&& value) {
+		Page* page = array[index];
+		while (page->count == PageSlots && page->overflow != nullptr) page = page->overflow;
+		if (page->count == PageSlots) {
+			page->overflow = new Page();
+			page = page->overflow;
+			++overflowcount;
+		}
+		page->tags[page->count] = linearhash_tag(h);
+		page->hashes[page->count] = h;
+		page->keys[page->count] = std::move(key);
+		page->values[page->count] = std::move(value);
+		++page->count;
+		++bucket_sizes[index];
+	}
+
+	// Quita el slot "slot" de la página "page" tapando el hueco con el último registro del bucket.
+	// Si la última página de overflow queda vacía, se libera.
+	void erase_slot(size_t index, Page* page, int slot) {
+		Page* prev = nullptr;
+		Page* last = array[index];
+		while (last->overflow != nullptr) {prev = last; last = last->overflow;}
+		int ls = last->count - 1;
+		if (last != page || ls != slot) {
+			page->tags[slot] = last->tags[ls];
+			page->hashes[slot] = last->hashes[ls];
+			page->keys[slot] = std::move(last->keys[ls]);
+			page->values[slot] = std::move(last->values[ls]);
+		}
+		last->keys[ls] = TK(); last->values[ls] = TV();
+		last->tags[ls] = 0;
+		--last->count;
+		--bucket_sizes[index];
+		--datacount;
+		if (last->count == 0 && prev != nullptr) {
+			delete last; --overflowcount;
+			prev->overflow = nullptr;
+		}
+	}
+
+	// Libera una cadena de páginas y devuelve cuántas eran
+	int free_chain(Page* page) {
+		int freed = 0;
+		while (page != nullptr) {
+			Page* temp = page;
+			page = page->overflow;
+			delete temp; ++freed;
+		}
+		return freed;
+	}
+
+public:
+	PagedLinearHash(int M0=4): array(new Page*[M0]()), bucket_sizes(new int[M0]()), visited(0),
+	overflowcount(0), M0(M0), p(0), i(0), datacount(0), bucketcount(M0), capacity(M0) {
+		for (int b = 0; b < bucketcount; ++b) array[b] = new Page();
+	}
+	PagedLinearHash(const PagedLinearHash&) = delete;
+	PagedLinearHash& operator=(const PagedLinearHash&) = delete;
+
+	int visited_buckets() {return visited;}
+	int size() {return datacount;}
+	int bucket_count() {return bucketcount;}
+	int overflow_pages() {return overflowcount;}
+	int bucket_size(int index) {
+		if (index < 0 || index >= bucketcount) throw std::runtime_error("Invalid bucket index");
+		return bucket_sizes[index];
+	}
+
+	void insert(TK key, TV value) {
+		size_t h = hash_of(key);
+		size_t index = hash_index(h);
+		int slot;
+		if (Page* page = find_slot(index, h, key, slot)) {page->values[slot] = std::move(value); return;}
+		append(index, h, std::move(key), std::move(value));
+		++visited;
+		++datacount;
+		if (fillFactor() > maxFillFactor) split();
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	TV operator[](const K& key) {
+		size_t h = hash_of(key);
+		int slot;
+		if (Page* page = find_slot(hash_index(h), h, key, slot)) return page->values[slot];
+		throw std::runtime_error("Key not found in linear hashing");
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	bool remove(const K& key) {
+		size_t h = hash_of(key);
+		size_t index = hash_index(h);
+		int slot;
+		Page* page = find_slot(index, h, key, slot);
+		if (page == nullptr) return false;
+		erase_slot(index, page, slot);
+		if (fillFactor() < lowerBound && capacity > M0) merge();
+		return true;
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	bool contains(const K& key) {
+		size_t h = hash_of(key);
+		int slot;
+		return find_slot(hash_index(h), h, key, slot) != nullptr;
+	}
+
+	template<LinearHashLookupKey<TK, LinearHashHasher<TK>> K>
+	bool try_get(const K& key, TV &out_value) {
+		size_t h = hash_of(key);
+		int slot;
+		Page* page = find_slot(hash_index(h), h, key, slot);
+		if (page == nullptr) return false;
+		out_value = page->values[slot];
+		return true;
+	}
+
+	// Borra todos los registros; cada bucket se queda solo con su página primaria
+	void clear() {
+		for (int b = 0; b < bucketcount; ++b) {
+			free_chain(array[b]);
+			array[b] = new Page();
+			bucket_sizes[b] = 0;
+		}
+		overflowcount = 0;
+		datacount = 0;
+		visited = 0;
+	}
+
+	void debug_print(const char* label = "") {
+		cout << "\n========== ESTADO PagedLinearHash " << label << " ==========\n";
+		cout << "M0=" << M0
+			 << "  i=" << i
+			 << "  p=" << p
+			 << "  bucketcount=" << bucketcount
+			 << "  capacity=" << capacity
+			 << "  datacount=" << datacount
+			 << "  overflow=" << overflowcount
+			 << "  fillFactor=" << fillFactor()
+			 << "\n";
+		for (int b = 0; b < bucketcount; ++b) {
+			cout << "Bucket " << b << " (size=" << bucket_sizes[b] << "): ";
+			if (bucket_sizes[b] == 0) cout << "[vacio]";
+			for (Page* page = array[b]; page != nullptr; page = page->overflow) {
+				if (page != array[b]) cout << " || ";
+				for (int s = 0; s < page->count; ++s) {
+					if (s > 0) cout << " | ";
+					cout << page->keys[s];
+				}
+			}
+			cout << "\n";
+		}
+		cout << "===========================================\n";
+	}
+
+	// Igual que LinearHash::for_each_remove_if: una sola pasada por bucket que compacta
+	// los registros que se quedan (mismo cursor de escritura que split) y libera las páginas
+	// de overflow vacías; los merges pendientes se hacen al final.
+	template<typename Func>
+	LinearHashSweepResult for_each_remove_if(Func callback) {
+		LinearHashSweepResult result;
+		for (int b = 0; b < bucketcount; ++b) {
+			Page* wpage = array[b];
+			int ws = 0;
+			for (Page* rpage = array[b]; rpage != nullptr; rpage = rpage->overflow) {
+				int rcount = rpage->count;
+				for (int rs = 0; rs < rcount; ++rs) {
+					++visited;
+					if (callback(rpage->keys[rs], rpage->values[rs])) {
+						rpage->keys[rs] = TK(); rpage->values[rs] = TV();
+						rpage->tags[rs] = 0;
+						--bucket_sizes[b]; --datacount; ++result.removed;
+						continue;
+					}
+					if (ws == PageSlots) {wpage->count = PageSlots; wpage = wpage->overflow; ws = 0;}
+					if (wpage != rpage || ws != rs) {
+						wpage->tags[ws] = rpage->tags[rs];
+						rpage->tags[rs] = 0;
+						wpage->hashes[ws] = rpage->hashes[rs];
+						wpage->keys[ws] = std::move(rpage->keys[rs]);
+						wpage->values[ws] = std::move(rpage->values[rs]);
+					}
+					++ws;
+				}
+			}
+			wpage->count = ws;
+			overflowcount -= free_chain(wpage->overflow);
+			wpage->overflow = nullptr;
+		}
+		while (fillFactor() < lowerBound && capacity > M0) {
+			merge();
+			++result.merges;
+		}
+		return result;
+	}
+
+private:
+	// Divide el bucket p: los registros se mueven página a página,
+	// compactando los que se quedan y agregando al final del nuevo bucket los que se van.
+	void split() {
+		if (p == 0) {
+			auto oldcapacity = capacity; capacity *= 2;
+			Page** new_array = new Page*[capacity]();
+			int* new_bucket_sizes = new int[capacity]();
+			for (int b = 0; b < oldcapacity; ++b) {
+				new_array[b] = array[b];
+				new_bucket_sizes[b] = bucket_sizes[b];
+			}
+			delete[] array; delete[] bucket_sizes;
+			array = new_array; bucket_sizes = new_bucket_sizes;
+		}
+		size_t newbucket = bucketcount;
+		array[newbucket] = new Page();
+		++bucketcount;
+		// Cursor de escritura (wpage, ws) dentro de la cadena de p: siempre va detrás del de lectura
+		Page* wpage = array[p];
+		int ws = 0;
+		for (Page* rpage = array[p]; rpage != nullptr; rpage = rpage->overflow) {
+			int rcount = rpage->count;
+			for (int rs = 0; rs < rcount; ++rs) {
+				++visited;
+				size_t h = rpage->hashes[rs];
+				if (extended_hash_index(h) != size_t(p)) {
+					--bucket_sizes[p];
+					append(newbucket, h, std::move(rpage->keys[rs]), std::move(rpage->values[rs]));
+					rpage->keys[rs] = TK(); rpage->values[rs] = TV();
+					rpage->tags[rs] = 0;
+					continue;
+				}
+				if (ws == PageSlots) {wpage->count = PageSlots; wpage = wpage->overflow; ws = 0;}
+				if (wpage != rpage || ws != rs) {
+					wpage->tags[ws] = rpage->tags[rs];
+					rpage->tags[rs] = 0;
+					wpage->hashes[ws] = h;
+					wpage->keys[ws] = std::move(rpage->keys[rs]);
+					wpage->values[ws] = std::move(rpage->values[rs]);
+				}
+				++ws;
+			}
+		}
+		// Cerrar la página de escritura y liberar las páginas que quedaron vacías detrás
+		wpage->count = ws;
+		overflowcount -= free_chain(wpage->overflow);
+		wpage->overflow = nullptr;
+		++p;
+		if (p == (M0 * (1 << i))) {
+			++i; p = 0;
+		}
+	}
+
+	// Junta el último bucket lógico con el bucket p-1 moviendo sus registros página a página
+	void merge() {
+		if (p == 0) {
+			--i; p = M0 * (1 << i) - 1;
+		} else --p;
+		size_t last = bucketcount - 1;
+		for (Page* page = array[last]; page != nullptr; page = page->overflow) {
+			for (int s = 0; s < page->count; ++s) {
+				++visited;
+				append(p, page->hashes[s], std::move(page->keys[s]), std::move(page->values[s]));
+			}
+		}
+		overflowcount -= free_chain(array[last]) - 1;
+		array[last] = nullptr;
+		bucket_sizes[last] = 0;
+		--bucketcount;
+		if (p == 0) {
+			capacity /= 2;
+			Page** new_array = new Page*[capacity]();
+			int* new_bucket_sizes = new int[capacity]();
+			for (int b = 0; b < capacity; ++b) {
+				new_array[b] = array[b];
+				new_bucket_sizes[b] = bucket_sizes[b];
+			}
+			delete[] array; delete[] bucket_sizes;
+			array = new_array; bucket_sizes = new_bucket_sizes;
+		}
+	}
+
+public:
+	~PagedLinearHash() {
+		for (int b = 0; b < bucketcount; ++b) free_chain(array[b]);
+		delete[] array;
+		delete[] bucket_sizes;
+	}
+};
+
+#endif //PAGEDLINEARHASH_H
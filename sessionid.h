@@ -0,0 +1,146 @@
+#ifndef SESSIONID_H
+#define SESSIONID_H
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include "linearhash_hash.h"
+#include "tokenrng.h"
+
+// Identificador de sesión de 128 bits: la clave de la tabla de sesiones.
+//   hi: ticks de system_clock al crearla (ordena los tokens por fecha)
+//   lo: parte aleatoria (la que hace imposible adivinar un token)
+// Trivialmente copiable y de 16 bytes: el nodo la guarda adentro (sin memoria dinámica),
+// compararla son dos comparaciones de 64 bits y los snapshots / el WAL la escriben tal cual.
+//
+// Forma externa (la que ve el cliente): "<hi>_<lo>" en decimal, la misma que tenían los
+// tokens string, así los clientes no cambian. Se convierte solo en los bordes: al armar la
+// respuesta de /login y al leer el token de un request; la tabla nunca ve strings.
+struct SessionId {
+	uint64_t hi = 0;
+	uint64_t lo = 0;
+
+	friend bool operator==(const SessionId&, const SessionId&) = default;
+	// Orden por hi y después lo: entre ids, el más chico es el más viejo
+	friend auto operator<=>(const SessionId&, const SessionId&) = default;
+};
+
+// Emisión de ids: hi = ticks de ahora, lo = 64 bits del generador criptográfico del hilo
+// (tokenrng.h; sin random_device ni llamadas al sistema después de la primera vez en cada hilo)
+inline SessionId mint_session_id() {
+	return SessionId{uint64_t(std::chrono::system_clock::now().time_since_epoch().count()), thread_token_rng()()};
+}
+
+// Por lotes (cargas masivas, pruebas de carga): un solo reloj para todo el lote y la parte
+// aleatoria pedida de a bloques
+inline void mint_session_ids(std::span<SessionId> out) {
+	uint64_t now = uint64_t(std::chrono::system_clock::now().time_since_epoch().count());
+	TokenRng& rng = thread_token_rng();
+	uint64_t random[64];
+	for (size_t done = 0; done < out.size(); done += 64) {
+		size_t count = std::min<size_t>(64, out.size() - done);
+		rng.fill(random, count * sizeof(uint64_t));
+		for (size_t k = 0; k < count; ++k) out[done + k] = SessionId{now, random[k]};
+	}
+	std::memset(random, 0, sizeof(random));
+}
+
+// Largo máximo de la forma externa: dos uint64 en decimal (20 dígitos cada uno) + '_'
+constexpr size_t session_id_max_chars = 41;
+
+// Escribe la forma externa en "out" (al menos session_id_max_chars) y devuelve el largo
+inline size_t session_id_format(const SessionId& id, char* out) {
+	char* end = std::to_chars(out, out + 20, id.hi).ptr;
+	*end++ = '_';
+	end = std::to_chars(end, end + 20, id.lo).ptr;
+	return size_t(end - out);
+}
+
+inline std::string to_string(const SessionId& id) {
+	char buffer[session_id_max_chars];
+	return std::string(buffer, session_id_format(id, buffer));
+}
+
+inline std::ostream& operator<<(std::ostream& out, const SessionId& id) {
+	char buffer[session_id_max_chars];
+	return out.write(buffer, std::streamsize(session_id_format(id, buffer)));
+}
+
+// Ocho dígitos ASCII de una vez (SWAR, en un registro de 64 bits): false si alguno no es dígito.
+// Solo en máquinas little endian (el primer carácter queda en el byte bajo).
+inline bool session_id_parse_8(const char* p, uint64_t& value) {
+	uint64_t chunk;
+	std::memcpy(&chunk, p, 8);
+	// Cada byte entre '0' (0x30) y '9' (0x39): nibble alto 3 y sumándole 6 no pasa de 0x3f
+	if (((chunk & 0xf0f0f0f0f0f0f0f0ull) | ((chunk + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4) !=
+		0x3333333333333333ull) return false;
+	chunk -= 0x3030303030303030ull;
+	chunk = (chunk * 10 + (chunk >> 8)) & 0x00ff00ff00ff00ffull;            // pares de dígitos
+	chunk = (chunk * 100 + (chunk >> 16)) & 0x0000ffff0000ffffull;          // grupos de 4
+	value = (chunk * 10000 + (chunk >> 32)) & 0xffffffffull;                // los 8
+	return true;
+}
+
+// Lee un uint64 en decimal de [begin, end); false si está vacío, si algo no es dígito, si hay
+// un cero a la izquierda o si no entra en 64 bits.
+// Los dígitos se alinean a la derecha en 24 bytes rellenos con '0' y se leen siempre tres
+// bloques de 8: sin loops que dependan del largo (19 o 20 dígitos según el token), así
+// el procesador no falla predicciones de saltos y puede seguir adelantando otros accesos.
+inline bool session_id_parse_part(const char* begin, const char* end, uint64_t& value) {
+	size_t length = size_t(end - begin);
+	if (length == 0 || length > 20 || (*begin == '0' && length > 1)) return false;
+	if constexpr (std::endian::native == std::endian::little) {
+		char digits[24];
+		std::memset(digits, '0', sizeof(digits));
+		std::memcpy(digits + sizeof(digits) - length, begin, length);
+		uint64_t top = 0, middle = 0, bottom = 0;
+		if (!(session_id_parse_8(digits, top) & session_id_parse_8(digits + 8, middle) &
+			  session_id_parse_8(digits + 16, bottom))) return false;
+		uint64_t low = middle * 100000000 + bottom;
+		// UINT64_MAX = 1844 6744073709551615
+		if (top > 1844 || (top == 1844 && low > 6744073709551615ull)) return false;
+		value = top * 10000000000000000ull + low;
+	} else {
+		value = 0;
+		for (; begin != end; ++begin) {
+			if (unsigned(*begin - '0') >= 10) return false;
+			uint64_t digit = uint64_t(*begin - '0');
+			if (value > (UINT64_MAX - digit) / 10) return false;
+			value = value * 10 + digit;
+		}
+	}
+	return true;
+}
+
+// Lee la forma externa; false si "text" no es exactamente "<dígitos>_<dígitos>" con cada
+// parte dentro de uint64 (sin signo, sin espacios, sin ceros a la izquierda, sin nada de
+// más al final): cada id tiene una sola forma externa
+inline bool parse_session_id(std::string_view text, SessionId& id) {
+	size_t separator = text.find('_');
+	if (separator == std::string_view::npos) return false;
+	const char* begin = text.data();
+	SessionId parsed;
+	if (!session_id_parse_part(begin, begin + separator, parsed.hi) ||
+		!session_id_parse_part(begin + separator + 1, begin + text.size(), parsed.lo)) return false;
+	id = parsed;
+	return true;
+}
+
+// Hash de un SessionId: una sola multiplicación 64x64 -> 128 (ver linearhash_mum).
+// hi cambia poco entre sesiones creadas seguidas; lo es aleatorio y la multiplicación lo
+// lleva a todos los bits, incluidos los bajos que eligen el bucket.
+struct SessionIdHasher {
+	size_t operator()(const SessionId& id) const noexcept {
+		return size_t(linearhash_mum(id.hi ^ linearhash_hash_secret[0], id.lo ^ linearhash_hash_secret[1]));
+	}
+};
+
+#endif //SESSIONID_H
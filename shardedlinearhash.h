@@ -0,0 +1,434 @@
+#ifndef SHARDEDLINEARHASH_H
+#define SHARDEDLINEARHASH_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "epoch.h"
+#include "linearhash.h"
+
+// N tablas LinearHash independientes ("shards"), cada una con su propio mutex.
+//  - Una clave va al shard que indican los bits ALTOS de su hash; dentro del shard
+//    LinearHash usa los bits bajos (hash % L), así que ambas elecciones no se pisan.
+//  - Cada operación toma solo el mutex de su shard: con N shards la contención baja ~N veces.
+//  - Los split/merge (y el crecimiento del directorio) pasan dentro de un shard y solo
+//    frenan a las operaciones de ese shard, nunca a toda la tabla.
+//  - N se fija al construir (al arrancar el servidor) y no cambia.
+// A diferencia de ConcurrentLinearHash, los valores se pueden modificar en el lugar
+// (for_each_remove_if recibe TV&).
+// Lecturas (try_get / contains / operator[]) sin lock mientras nadie escribe el shard:
+//  - el lector anuncia en su slot (uno por hilo, índice de EpochThreadRegistry) qué shard
+//    lee y después mira si ese shard tiene un escritor; si no, lee sin tomar el mutex;
+//  - el escritor toma el mutex, marca el shard como escrito y espera a que ningún slot
+//    anuncie ese shard antes de tocar la tabla;
+//  - un lector que encuentra el shard escrito retira su anuncio y toma el mutex como antes.
+// Así las lecturas de un mismo shard no se serializan entre sí; solo esperan a un escritor.
+// Hash / KeyEqual / NodeAlloc / Stats: los mismos parámetros que LinearHash (el hash elige
+// también el shard, con sus bits altos).
+template<typename TK, typename TV, typename Hash = LinearHashHasher<TK>, typename KeyEqual = std::equal_to<>,
+		 template<typename> class NodeAlloc = LinearHashNewDeleteAllocator, typename Stats = LinearHashNoStats>
+class ShardedLinearHash {
+	typedef LinearHash<TK, TV, Hash, KeyEqual, NodeAlloc, Stats> Table;
+
+	// Cada shard en su propia línea de caché (el mutex de uno no comparte línea con otro)
+	struct alignas(64) Shard {
+		std::mutex mutex;
+		std::atomic<bool> writing{false};   // hay un escritor (con el mutex) en este shard
+		Table table;
+		explicit Shard(int M0): table(M0) {}
+	};
+	// Shard que lee sin lock cada hilo (nullptr si ninguno), cada uno en su línea de caché
+	struct alignas(64) ReaderSlot {
+		std::atomic<const Shard*> shard{nullptr};
+	};
+
+	std::vector<std::unique_ptr<Shard>> shards;
+	std::unique_ptr<ReaderSlot[]> readers{new ReaderSlot[EpochThreadRegistry::max_threads]};
+	Hash hasher;
+	static constexpr char sharded_magic[8] = {'L', 'H', 'S', 'H', 'A', 'R', 'D', '1'};
+
+	// Shard de un hash: (32 bits altos * N) / 2^32, uniforme para cualquier N
+	template<typename K>
+	size_t shard_index(const K& key) {
+		uint64_t high = uint64_t(hasher(key)) >> 32;
+		return size_t((high * shards.size()) >> 32);
+	}
+	template<typename K>
+	Shard& shard_for(const K& key) {return *shards[shard_index(key)];}
+
+	// Lock de escritura de un shard: el mutex más la espera a que terminen los lectores sin
+	// lock que ya estaban adentro (los que llegan después ven writing y toman el mutex)
+	class WriteLock {
+		Shard& shard;
+	public:
+		WriteLock(Shard& shard, const ReaderSlot* readers): shard(shard) {
+			shard.mutex.lock();
+			shard.writing.store(true);
+			for (int t = 0, n = EpochThreadRegistry::thread_count(); t < n; ++t) {
+				while (readers[t].shard.load() == &shard) std::this_thread::yield();
+			}
+		}
+		~WriteLock() {
+			shard.writing.store(false, std::memory_order_release);
+			shard.mutex.unlock();
+		}
+		WriteLock(const WriteLock&) = delete;
+		WriteLock& operator=(const WriteLock&) = delete;
+	};
+	WriteLock write_lock(Shard& shard) {return WriteLock(shard, readers.get());}
+
+	// Corre read(tabla) en el shard de key: sin lock si no hay escritor, con el mutex si lo hay
+	template<typename K, typename Read>
+	decltype(auto) read_shard(const K& key, Read&& read) {
+		Shard& shard = shard_for(key);
+		std::atomic<const Shard*>& announced = readers[EpochThreadRegistry::slot()].shard;
+		announced.store(&shard);
+		if (!shard.writing.load()) {
+			struct Leave {
+				std::atomic<const Shard*>& announced;
+				~Leave() {announced.store(nullptr, std::memory_order_release);}
+			} leave{announced};
+			return read(shard.table);
+		}
+		announced.store(nullptr, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		return read(shard.table);
+	}
+
+public:
+	// shard_count: cantidad de shards (N); M0: buckets iniciales de cada shard
+	explicit ShardedLinearHash(size_t shard_count, int M0=4) {
+		if (shard_count == 0) shard_count = 1;
+		shards.reserve(shard_count);
+		for (size_t s = 0; s < shard_count; ++s) shards.push_back(std::make_unique<Shard>(M0));
+	}
+	ShardedLinearHash(const ShardedLinearHash&) = delete;
+	ShardedLinearHash& operator=(const ShardedLinearHash&) = delete;
+
+	size_t shard_count() const {return shards.size();}
+
+	// Suma de los tamaños de todos los shards (cada uno leído con su lock)
+	int size() {
+		int total = 0;
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			total += shard->table.size();
+		}
+		return total;
+	}
+	// Estadísticas de todos los shards sumadas (ver LinearHash::stats_snapshot)
+	LinearHashStatsSnapshot stats_snapshot() {
+		LinearHashStatsSnapshot total;
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			total += shard->table.stats_snapshot();
+		}
+		return total;
+	}
+
+	int bucket_count() {
+		int total = 0;
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			total += shard->table.bucket_count();
+		}
+		return total;
+	}
+
+	// Reparte la reserva entre los shards (las claves se distribuyen de forma uniforme)
+	void reserve(size_t n) {
+		size_t per_shard = (n + shards.size() - 1) / shards.size();
+		for (auto& shard : shards) {
+			auto lock = write_lock(*shard);
+			shard->table.reserve(per_shard);
+		}
+	}
+
+	// Presupuesto global repartido en partes iguales entre los shards (las claves se
+	// distribuyen de forma uniforme); cada shard desaloja con su propio CLOCK bajo su lock.
+	// evict se llama con el lock del shard tomado (ver LinearHash::set_budget).
+	void set_budget(LinearHashBudget total, std::function<void(const TK&, const TV&)> evict = {}) {
+		LinearHashBudget per_shard;
+		if (total.max_entries != 0) per_shard.max_entries = std::max<size_t>(1, total.max_entries / shards.size());
+		if (total.max_bytes != 0) per_shard.max_bytes = std::max<size_t>(1, total.max_bytes / shards.size());
+		for (auto& shard : shards) {
+			auto lock = write_lock(*shard);
+			shard->table.set_budget(per_shard, evict);
+		}
+	}
+	uint64_t evicted_count() {
+		uint64_t total = 0;
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			total += shard->table.evicted_count();
+		}
+		return total;
+	}
+	size_t memory_bytes() {
+		size_t total = 0;
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			total += shard->table.memory_bytes();
+		}
+		return total;
+	}
+
+	// Carga masiva: se agrupan las posiciones de la entrada por shard y cada shard
+	// se construye con LinearHash::bulk_build (un hilo por shard, "threads" a la vez)
+	template<std::ranges::random_access_range Items>
+	void bulk_build(const Items& items, unsigned threads = std::thread::hardware_concurrency()) {
+		size_t n = std::ranges::size(items);
+		std::vector<std::vector<size_t>> positions(shards.size());
+		for (size_t k = 0; k < n; ++k) positions[shard_index(items[k].first)].push_back(k);
+		std::atomic<size_t> next_shard(0);
+		auto work = [&] {
+			for (size_t s = next_shard++; s < shards.size(); s = next_shard++) {
+				auto shard_items = positions[s] | std::views::transform([&](size_t k) -> decltype(auto) {return items[k];});
+				auto lock = write_lock(*shards[s]);
+				shards[s]->table.bulk_build(shard_items, 1);
+			}
+		};
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < std::max(1u, threads); ++t) workers.emplace_back(work);
+		work();
+		for (auto& worker : workers) worker.join();
+	}
+
+	template<typename K, typename V>
+	void insert(K&& key, V&& value) {insert_or_assign(std::forward<K>(key), std::forward<V>(value));}
+
+	// Devuelven true si se insertó un nodo nuevo (un puntero al valor no puede salir del lock)
+	template<typename K, typename... Args>
+	bool try_emplace(K&& key, Args&&... args) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		return shard.table.try_emplace(std::forward<K>(key), std::forward<Args>(args)...).second;
+	}
+
+	template<typename K, typename V>
+	bool insert_or_assign(K&& key, V&& value) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		return shard.table.insert_or_assign(std::forward<K>(key), std::forward<V>(value)).second;
+	}
+
+	// El shard depende de la clave: se toma el primer argumento como clave
+	template<typename K, typename... Args>
+	bool emplace(K&& key, Args&&... args) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		return shard.table.emplace(std::forward<K>(key), std::forward<Args>(args)...).second;
+	}
+
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	TV operator[](const K& key) {
+		return read_shard(key, [&](Table& table) -> TV {return table[key];});
+	}
+
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	bool remove(const K& key) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		return shard.table.remove(key);
+	}
+
+	// Borra solo si pred(valor) da true; pred corre con el lock del shard tomado
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K, typename Pred>
+	bool remove_if(const K& key, Pred&& pred) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		return shard.table.remove_if(key, pred);
+	}
+
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	bool contains(const K& key) {
+		return read_shard(key, [&](Table& table) {return table.contains(key);});
+	}
+
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K>
+	bool try_get(const K& key, TV &out_value) {
+		return read_shard(key, [&](Table& table) {return table.try_get(key, out_value);});
+	}
+
+	// Modifican el valor de key en el lugar, con el lock del shard tomado (fn no puede volver
+	// a entrar a esta tabla):
+	//  - upsert: si key no está la crea con TV(); devuelve lo que devuelva fn(TV&)
+	//  - update: solo si key está (devuelve false si no); si fn(TV&) da false, se borra key
+	template<typename K, typename Fn>
+	auto upsert(K&& key, Fn&& fn) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		return fn(*shard.table.try_emplace(std::forward<K>(key)).first);
+	}
+
+	template<LinearHashLookupKey<TK, Hash, KeyEqual> K, typename Fn>
+	bool update(const K& key, Fn&& fn) {
+		Shard& shard = shard_for(key);
+		auto lock = write_lock(shard);
+		TV* value = shard.table.find(key);
+		if (value == nullptr) return false;
+		if (!fn(*value)) shard.table.remove(key);
+		return true;
+	}
+
+	// Vacía shard por shard: los demás shards siguen atendiendo mientras tanto
+	void clear() {
+		for (auto& shard : shards) {
+			auto lock = write_lock(*shard);
+			shard->table.clear();
+		}
+	}
+
+	// Recorre shard por shard (cada uno con su lock); callback(key, value) igual que en LinearHash.
+	// Los merges que dispare la limpieza ocurren dentro de cada shard; se suman los de todos.
+	template<typename Func>
+	LinearHashSweepResult for_each_remove_if(Func callback) {
+		LinearHashSweepResult result;
+		for (auto& shard : shards) {
+			auto lock = write_lock(*shard);
+			result += shard->table.for_each_remove_if(callback);
+		}
+		return result;
+	}
+
+	// Aplica fn(key, value) a todos los elementos, shard por shard (cada uno con su lock)
+	template<typename Func>
+	void for_each(Func fn) {
+		for (auto& shard : shards) {
+			auto lock = write_lock(*shard);
+			for (auto entry : shard->table) fn(entry.key, entry.value);
+		}
+	}
+
+	// Como for_each pero con "threads" hilos tomando shards (fn debe poder correr en paralelo).
+	// Mientras un shard se recorre solo ese shard queda bloqueado.
+	template<typename Func>
+	void parallel_for_each(Func fn, unsigned threads = std::thread::hardware_concurrency()) {
+		std::atomic<size_t> next_shard(0);
+		auto work = [&] {
+			for (size_t s = next_shard++; s < shards.size(); s = next_shard++) {
+				auto lock = write_lock(*shards[s]);
+				for (auto entry : shards[s]->table) fn(entry.key, entry.value);
+			}
+		};
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < std::max(1u, threads); ++t) workers.emplace_back(work);
+		work();
+		for (auto& worker : workers) worker.join();
+	}
+
+	// Snapshot de todos los shards en un solo archivo:
+	//   "LHSHARD1", cantidad de shards (uint64), tabla de (offset, largo) uint64 por shard,
+	//   y a continuación el snapshot de cada shard (formato de LinearHash::write_snapshot).
+	// Cada shard se escribe con su lock tomado (cada uno es consistente por sí mismo).
+	template<typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+	void save_snapshot(const std::string& path) {
+		std::string tmp = path + ".tmp";
+		{
+			std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+			if (!out) throw std::runtime_error("ShardedLinearHash snapshot: cannot create " + tmp);
+			uint64_t count = shards.size();
+			std::vector<uint64_t> table(2 * shards.size(), 0);
+			out.write(sharded_magic, sizeof(sharded_magic));
+			out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+			auto table_position = out.tellp();
+			out.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(uint64_t)));
+			for (size_t s = 0; s < shards.size(); ++s) {
+				table[2 * s] = uint64_t(out.tellp());
+				{
+					std::lock_guard<std::mutex> lock(shards[s]->mutex);
+					shards[s]->table.template write_snapshot<KeySer, ValueSer>(out);
+				}
+				table[2 * s + 1] = uint64_t(out.tellp()) - table[2 * s];
+			}
+			out.seekp(table_position);
+			out.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(uint64_t)));
+			if (!out) throw std::runtime_error("ShardedLinearHash snapshot: write failed");
+		}
+		std::filesystem::rename(tmp, path);
+	}
+
+	// Reemplaza el contenido con el snapshot (archivo mapeado en memoria). Si la cantidad de
+	// shards es la misma, cada shard se carga directo (sin rehashear) y "threads" shards a la vez;
+	// si no (el servidor arrancó con otro N), cada shard del archivo se carga aparte y sus
+	// elementos se reparten entre los shards actuales.
+	template<typename KeySer = LinearHashSerializer<TK>, typename ValueSer = LinearHashSerializer<TV>>
+	void load_snapshot(const std::string& path, unsigned threads = std::thread::hardware_concurrency()) {
+		LinearHashMappedFile file(path);
+		const char* data = file.data();
+		size_t size = file.size();
+		uint64_t count;
+		linearhash_snapshot_check(size >= sizeof(sharded_magic) + sizeof(count) &&
+								  std::memcmp(data, sharded_magic, sizeof(sharded_magic)) == 0, "bad sharded header");
+		std::memcpy(&count, data + sizeof(sharded_magic), sizeof(count));
+		const char* table = data + sizeof(sharded_magic) + sizeof(count);
+		linearhash_snapshot_check(count > 0 && count <= (size - (table - data)) / (2 * sizeof(uint64_t)), "bad shard table");
+		auto region = [&](size_t s) {
+			uint64_t entry[2];
+			std::memcpy(entry, table + 2 * s * sizeof(uint64_t), sizeof(entry));
+			linearhash_snapshot_check(entry[0] <= size && entry[1] <= size - entry[0], "bad shard region");
+			return std::pair<const char*, size_t>(data + entry[0], size_t(entry[1]));
+		};
+
+		// Cada blob va directo a su shard solo si hay tantos shards como al guardar y el hasher
+		// es el mismo (con otro hasher las claves caen en otros shards: se redistribuyen)
+		auto same_hasher = [&] {
+			auto [begin, length] = region(0);
+			LinearHashSnapshotHeader header;
+			if (length < sizeof(header)) return false;
+			std::memcpy(&header, begin, sizeof(header));
+			std::lock_guard<std::mutex> lock(shards[0]->mutex);
+			return header.hash_fingerprint == shards[0]->table.hash_fingerprint();
+		};
+		clear();
+		if (count == shards.size() && same_hasher()) {
+			std::atomic<size_t> next_shard(0);
+			std::mutex error_mutex;
+			std::exception_ptr error;
+			auto work = [&] {
+				for (size_t s = next_shard++; s < shards.size(); s = next_shard++) {
+					try {
+						auto [begin, length] = region(s);
+						auto lock = write_lock(*shards[s]);
+						shards[s]->table.template load_snapshot_from_memory<KeySer, ValueSer>(begin, length, 1);
+					} catch (...) {
+						std::lock_guard<std::mutex> lock(error_mutex);
+						if (!error) error = std::current_exception();
+					}
+				}
+			};
+			std::vector<std::thread> workers;
+			for (unsigned t = 1; t < std::max(1u, threads); ++t) workers.emplace_back(work);
+			work();
+			for (auto& worker : workers) worker.join();
+			if (error) {clear(); std::rethrow_exception(error);}
+			return;
+		}
+		for (size_t s = 0; s < count; ++s) {
+			auto [begin, length] = region(s);
+			Table loaded;
+			loaded.template load_snapshot_from_memory<KeySer, ValueSer>(begin, length, threads);
+			for (auto entry : loaded) insert_or_assign(entry.key, std::move(entry.value));
+		}
+	}
+
+	void debug_print(const char* label = "") {
+		cout << "\n########## ESTADO ShardedLinearHash " << label << " ##########\n";
+		cout << "shards=" << shards.size() << "\n";
+		for (size_t s = 0; s < shards.size(); ++s) {
+			std::lock_guard<std::mutex> lock(shards[s]->mutex);
+			std::string shard_label = "shard " + std::to_string(s);
+			shards[s]->table.debug_print(shard_label.c_str());
+		}
+	}
+};
+
+#endif //SHARDEDLINEARHASH_H
@@ -0,0 +1,166 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "linearhash.h"
+
+// Índice de vencimientos: timing wheel jerárquico (Varghese & Lauck).
+// El tiempo avanza en ticks de duración fija. Hay "levels" ruedas de 64 slots:
+// la rueda 0 tiene un slot por tick, la rueda 1 un slot por cada 64 ticks, la 2 uno
+// por cada 64^2, etc. Una clave se agenda en la rueda más baja que alcance su
+// vencimiento; cuando la rueda de abajo da la vuelta, el slot que toca de la rueda de
+// arriba se "derrama" y sus claves bajan de rueda. Agendar es O(1) y advance() solo
+// toca las claves que vencen (más los derrames, que cada clave sufre como mucho
+// levels - 1 veces).
+//
+// Cancelación: un LinearHash (positions) guarda dónde está cada clave agendada (rueda,
+// slot y posición en el vector), así cancel() la saca en O(1) (la última del slot ocupa
+// su lugar) y la rueda guarda solo claves vivas: una clave borrada de la tabla sin
+// cancelarse sigue ocupando su lugar hasta que vence. Cada movimiento de una entrada
+// (agendar, derrame, cancelación) actualiza su posición.
+//
+// Thread-safe: todas las operaciones toman un mutex.
+
+template<typename TK, int Levels = 4, typename Hash = LinearHashHasher<TK>>
+class TimingWheel {
+public:
+	typedef std::chrono::system_clock Clock;
+
+private:
+	static constexpr int slot_bits = 6;
+	static constexpr uint64_t slots = uint64_t(1) << slot_bits;
+	static constexpr uint64_t slot_mask = slots - 1;
+
+	struct Entry {
+		TK key;
+		uint64_t tick;   // tick en el que vence
+	};
+	// Dónde está una clave: wheels[level][slot][index]
+	struct Position {
+		int level;
+		int slot;
+		size_t index;
+	};
+
+	std::mutex mutex;
+	Clock::duration tick_length;
+	uint64_t current;    // próximo tick a procesar
+	std::array<std::array<std::vector<Entry>, slots>, Levels> wheels;
+	LinearHash<TK, Position, Hash> positions;
+
+	// Primer tick que empieza en o después de "time" (vencer antes nunca; tarde, menos de un tick)
+	uint64_t tick_of(Clock::time_point time) const {
+		auto since = time.time_since_epoch();
+		if (since.count() <= 0) return 0;
+		return uint64_t((since + tick_length - Clock::duration(1)) / tick_length);
+	}
+
+	void place(Entry&& entry) {
+		uint64_t tick = entry.tick < current ? current : entry.tick;
+		uint64_t delta = tick - current;
+		for (int level = 0; level < Levels; ++level) {
+			if (delta < (uint64_t(1) << (slot_bits * (level + 1))) || level == Levels - 1) {
+				// Más allá de la última rueda: se deja en el último slot que alcanza y se
+				// vuelve a ubicar cuando se derrame
+				if (level == Levels - 1 && delta >= (uint64_t(1) << (slot_bits * Levels)))
+					tick = current + (uint64_t(1) << (slot_bits * Levels)) - 1;
+				int slot = int((tick >> (slot_bits * level)) & slot_mask);
+				std::vector<Entry>& entries = wheels[level][slot];
+				entries.push_back(std::move(entry));
+				positions.insert_or_assign(entries.back().key, Position{level, slot, entries.size() - 1});
+				return;
+			}
+		}
+	}
+
+	// Saca del slot la entrada que está en "at" (la última del slot pasa a su lugar);
+	// la posición de la clave sacada la borra quien llama
+	void unlink(Position at) {
+		std::vector<Entry>& entries = wheels[at.level][at.slot];
+		if (at.index + 1 != entries.size()) {
+			entries[at.index] = std::move(entries.back());
+			*positions.find(entries[at.index].key) = at;
+		}
+		entries.pop_back();
+	}
+
+public:
+	explicit TimingWheel(Clock::duration tick_length = std::chrono::seconds(1), Clock::time_point start = Clock::now()):
+		tick_length(tick_length) {
+		current = tick_of(start);
+	}
+	TimingWheel(const TimingWheel&) = delete;
+	TimingWheel& operator=(const TimingWheel&) = delete;
+
+	// Agenda "key" para que advance() la devuelva en cuanto se pase "deadline"
+	// (si ya pasó, en el próximo advance). Si ya estaba agendada, se reprograma.
+	void schedule(TK key, Clock::time_point deadline) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (Position* at = positions.find(key)) unlink(*at);
+		place(Entry{std::move(key), tick_of(deadline)});
+	}
+
+	// Saca "key" de la rueda (advance ya no la devuelve); false si no estaba agendada
+	bool cancel(const TK& key) {
+		std::lock_guard<std::mutex> lock(mutex);
+		Position* at = positions.find(key);
+		if (at == nullptr) return false;
+		unlink(*at);
+		positions.remove(key);
+		return true;
+	}
+
+	// Procesa todos los ticks hasta "now" y devuelve las claves vencidas, en orden de vencimiento
+	std::vector<TK> advance(Clock::time_point now = Clock::now()) {
+		std::vector<TK> expired;
+		std::lock_guard<std::mutex> lock(mutex);
+		// Se procesa cada tick cuyo comienzo ya pasó: lo que vence en él ya venció
+		auto since = now.time_since_epoch();
+		if (since.count() < 0) return expired;
+		uint64_t target = uint64_t(since / tick_length);
+		while (current <= target) {
+			// Si la rueda 0 dio la vuelta, se derraman los slots de arriba que tocan
+			if ((current & slot_mask) == 0) {
+				for (int level = 1; level < Levels; ++level) {
+					uint64_t index = (current >> (slot_bits * level)) & slot_mask;
+					std::vector<Entry> spill;
+					spill.swap(wheels[level][index]);
+					for (Entry& entry : spill) place(std::move(entry));
+					if (index != 0) break;
+				}
+			}
+			std::vector<Entry>& slot = wheels[0][current & slot_mask];
+			for (Entry& entry : slot) {
+				positions.remove(entry.key);
+				expired.push_back(std::move(entry.key));
+			}
+			slot.clear();
+			++current;
+		}
+		return expired;
+	}
+
+	// Vacía la rueda (p. ej. después de borrar toda la tabla)
+	void clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& wheel : wheels) {
+			for (std::vector<Entry>& slot : wheel) std::vector<Entry>().swap(slot);
+		}
+		positions.clear();
+	}
+
+	// Claves agendadas que todavía no vencieron ni se cancelaron
+	size_t size() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return size_t(positions.size());
+	}
+
+	Clock::duration tick() const {return tick_length;}
+};
+
+#endif //TIMINGWHEEL_H
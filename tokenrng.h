@@ -0,0 +1,136 @@
+#ifndef TOKENRNG_H
+#define TOKENRNG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <bcrypt.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "bcrypt")
+#endif
+#else
+#include <unistd.h>
+#ifdef __APPLE__
+#include <sys/random.h>
+#endif
+#endif
+
+// Generador de números aleatorios criptográfico para los tokens de sesión (ChaCha20).
+//  - Se siembra una sola vez, con 32 bytes de entropía del sistema operativo
+//    (getentropy / BCryptGenRandom); después no hace ninguna llamada al sistema.
+//  - Cada recarga genera refill_blocks bloques de ChaCha20 de una vez: los primeros 32 bytes
+//    pasan a ser la clave nueva y el resto se entrega ("fast key erasure", como arc4random
+//    de OpenBSD). Los bytes entregados se borran del buffer: si alguien lee la memoria del
+//    proceso no puede reconstruir tokens ya emitidos.
+//  - No es thread-safe: cada hilo usa el suyo (thread_token_rng()).
+// Cumple UniformRandomBitGenerator, así que sirve también con las distribuciones de <random>.
+
+// Bytes aleatorios del sistema operativo; lanza si no hay (no hay un plan B seguro)
+inline void os_entropy(void* out, size_t length) {
+	unsigned char* bytes = static_cast<unsigned char*>(out);
+#ifdef _WIN32
+	if (BCryptGenRandom(nullptr, bytes, ULONG(length), BCRYPT_USE_SYSTEM_PREFERRED_RNG) < 0)
+		throw std::runtime_error("os_entropy: BCryptGenRandom failed");
+#else
+	// getentropy entrega como mucho 256 bytes por llamada
+	while (length > 0) {
+		size_t chunk = length < 256 ? length : 256;
+		if (::getentropy(bytes, chunk) != 0) throw std::runtime_error("os_entropy: getentropy failed");
+		bytes += chunk; length -= chunk;
+	}
+#endif
+}
+
+inline uint32_t tokenrng_rotl(uint32_t value, int bits) {return (value << bits) | (value >> (32 - bits));}
+
+// Un bloque de ChaCha20 (RFC 8439): 20 rondas sobre "in" más la suma final
+inline void tokenrng_chacha20_block(const uint32_t in[16], uint32_t out[16]) {
+	uint32_t x[16];
+	std::memcpy(x, in, sizeof(x));
+	auto quarter = [&x](int a, int b, int c, int d) {
+		x[a] += x[b]; x[d] = tokenrng_rotl(x[d] ^ x[a], 16);
+		x[c] += x[d]; x[b] = tokenrng_rotl(x[b] ^ x[c], 12);
+		x[a] += x[b]; x[d] = tokenrng_rotl(x[d] ^ x[a], 8);
+		x[c] += x[d]; x[b] = tokenrng_rotl(x[b] ^ x[c], 7);
+	};
+	for (int round = 0; round < 10; ++round) {
+		quarter(0, 4, 8, 12); quarter(1, 5, 9, 13); quarter(2, 6, 10, 14); quarter(3, 7, 11, 15);
+		quarter(0, 5, 10, 15); quarter(1, 6, 11, 12); quarter(2, 7, 8, 13); quarter(3, 4, 9, 14);
+	}
+	for (int k = 0; k < 16; ++k) out[k] = x[k] + in[k];
+}
+
+class TokenRng {
+	static constexpr size_t block_bytes = 64;
+	static constexpr size_t refill_blocks = 16;
+	static constexpr size_t key_bytes = 32;
+
+	uint32_t key[8];
+	alignas(64) unsigned char buffer[block_bytes * refill_blocks];
+	size_t position = sizeof(buffer);   // próximo byte sin entregar
+
+	void refill() {
+		// Con la clave rotando en cada recarga alcanza con contador 0..refill_blocks - 1 y nonce 0
+		uint32_t state[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};   // "expand 32-byte k"
+		std::memcpy(state + 4, key, key_bytes);
+		for (size_t block = 0; block < refill_blocks; ++block) {
+			state[12] = uint32_t(block);
+			uint32_t words[16];
+			tokenrng_chacha20_block(state, words);
+			std::memcpy(buffer + block * block_bytes, words, block_bytes);
+		}
+		std::memcpy(key, buffer, key_bytes);
+		std::memset(buffer, 0, key_bytes);
+		std::memset(state, 0, sizeof(state));
+		position = key_bytes;
+	}
+
+public:
+	typedef uint64_t result_type;
+
+	TokenRng() {os_entropy(key, sizeof(key));}
+	TokenRng(const TokenRng&) = delete;
+	TokenRng& operator=(const TokenRng&) = delete;
+	~TokenRng() {
+		volatile unsigned char* wipe = buffer;
+		for (size_t k = 0; k < sizeof(buffer); ++k) wipe[k] = 0;
+		std::memset(key, 0, sizeof(key));
+	}
+
+	// Llena "out" con "length" bytes aleatorios
+	void fill(void* out, size_t length) {
+		unsigned char* bytes = static_cast<unsigned char*>(out);
+		while (length > 0) {
+			if (position == sizeof(buffer)) refill();
+			size_t chunk = sizeof(buffer) - position;
+			if (chunk > length) chunk = length;
+			std::memcpy(bytes, buffer + position, chunk);
+			std::memset(buffer + position, 0, chunk);
+			position += chunk; bytes += chunk; length -= chunk;
+		}
+	}
+
+	uint64_t operator()() {
+		uint64_t value;
+		fill(&value, sizeof(value));
+		return value;
+	}
+	static constexpr result_type min() {return 0;}
+	static constexpr result_type max() {return std::numeric_limits<result_type>::max();}
+};
+
+// Generador del hilo actual: se siembra la primera vez que el hilo lo pide
+inline TokenRng& thread_token_rng() {
+	thread_local TokenRng rng;
+	return rng;
+}
+
+#endif //TOKENRNG_H